@@ -0,0 +1,316 @@
+#pragma once
+
+#ifndef _CPP_ITERATORS_CONCURRENT_QUEUE_H_
+#define _CPP_ITERATORS_CONCURRENT_QUEUE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "iterators.h"
+
+namespace iterators {
+
+// A bounded queue that any number of threads can push to and pop from at the same time, without locks.
+//
+// Every slot has a sequence number that tells whether it is ready to be written or read for a given position,
+// so pushing or popping an element costs a single compare-and-swap on the position, and a store to the slot.
+// 'Close()' stops accepting new elements, and tells the readers to stop once they popped all the others.
+//
+// Simply write this:
+//
+// ConcurrentQueue<Record> records{1024};
+// // On the ingestion threads
+// records.Push(std::move(record));
+// // On the consumer threads
+// for (const auto& record : Consume(records).filter(is_valid))
+//   Store(record);
+template <typename T> class ConcurrentQueue {
+ public:
+  using value_type = T;
+
+  // 'capacity' is rounded up to a power of 2 (and at least 2, as a slot that was just written for 'position' is
+  // marked as 'position + 1', just like a slot that can be written for the next position in a queue of 1 slot)
+  explicit ConcurrentQueue(std::size_t capacity);
+  ConcurrentQueue(const ConcurrentQueue&) = delete;
+  ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+
+  std::size_t capacity() const { return mask_ + 1; }
+
+  // Pushes 'value', returns false (without moving 'value') if the queue is full or closed
+  template <typename U> bool TryPush(U&& value);
+  // Pushes 'value' once there is room for it, returns false (without moving 'value') if the queue is closed
+  template <typename U> bool Push(U&& value);
+
+  // Pops the oldest element, returns false if the queue is empty
+  bool TryPop(T& value) { return TryPopBatch(&value, 1) == 1; }
+  // Pops up to 'max_count' of the oldest elements into 'values' with a single compare-and-swap,
+  // and returns how many it popped (0 if the queue is empty)
+  template <typename OutputIterator> std::size_t TryPopBatch(OutputIterator values, std::size_t max_count);
+
+  // Stops accepting new elements. The elements already pushed can still be popped.
+  void Close() { enqueue_position_.fetch_or(kClosed, std::memory_order_acq_rel); }
+  bool IsClosed() const { return (enqueue_position_.load(std::memory_order_acquire) & kClosed) != 0; }
+  // True once the queue is closed and all its elements have been popped
+  bool IsDrained() const;
+
+ private:
+  struct Slot {
+    // 'position' if the slot can be written for 'position', 'position + 1' if it can be read for 'position'
+    std::atomic<std::size_t> sequence{0};
+    T value{};
+  };
+
+  // Set in the enqueue position once the queue is closed, so closing and pushing can't race
+  static constexpr std::size_t kClosed = std::size_t{1} << (sizeof(std::size_t) * 8 - 1);
+
+  static std::size_t Capacity(std::size_t requested) {
+    std::size_t result = 2;
+    while (result < requested)
+      result *= 2;
+    return result;
+  }
+  static std::ptrdiff_t Difference(std::size_t sequence, std::size_t position) {
+    return static_cast<std::ptrdiff_t>(sequence - position);
+  }
+
+  std::size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<std::size_t> enqueue_position_{0};
+  char enqueue_padding_[64 - sizeof(std::atomic<std::size_t>)];
+  std::atomic<std::size_t> dequeue_position_{0};
+  char dequeue_padding_[64 - sizeof(std::atomic<std::size_t>)];
+};
+
+// Iterates over the elements popped from 'queue' until it is closed and drained.
+//
+// Every iteration (every call to 'begin()') pops its elements in batches, so it only takes a compare-and-swap
+// for every batch, and waits while the queue is empty. Any number of threads can each iterate over their own
+// 'Consume(queue)', and every element is returned by only one of them.
+// The iterators are input iterators, so iterate only once over each 'begin()'.
+template <typename T> auto Consume(ConcurrentQueue<T>& queue);
+
+//-----------------------------------------------------------------------------
+// Implementation
+//-----------------------------------------------------------------------------
+
+namespace details {
+
+// Calls 'ready()' until it returns true: spins for a short wait, then yields to other threads,
+// and finally sleeps (for up to 100 microseconds at a time) so a long wait does not keep a core busy
+template <typename Ready> void Await(const Ready& ready) {
+  for (int attempt = 0; !ready(); attempt = std::min(attempt + 1, 4096)) {
+    if (attempt < 64)
+      continue;
+    if (attempt < 1024)
+      std::this_thread::yield();
+    else
+      std::this_thread::sleep_for(std::chrono::microseconds(std::min(100, (attempt - 1024) / 16 + 1)));
+  }
+}
+
+// A fixed-size queue between a single producer thread and a single consumer thread, which never blocks or locks.
+// The positions only ever grow, and are padded to cache lines, so both threads don't slow each other down.
+template <typename T> class SpscRing {
+ public:
+  explicit SpscRing(std::size_t size) : slots_(size) {}
+
+  // Moves 'value' into the queue, returns false if it is full
+  bool TryPush(T& value) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == slots_.size())
+      return false;
+    slots_[tail % slots_.size()] = std::move(value);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Moves the oldest value out of the queue, returns false if it is empty
+  bool TryPop(T& value) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire))
+      return false;
+    value = std::move(slots_[head % slots_.size()]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  std::vector<T> slots_;
+  std::atomic<std::size_t> head_{0};  // The position of the next value to pop, only written by the consumer
+  char head_padding_[64 - sizeof(std::atomic<std::size_t>)];
+  std::atomic<std::size_t> tail_{0};  // The position of the next value to push, only written by the producer
+  char tail_padding_[64 - sizeof(std::atomic<std::size_t>)];
+};
+
+// The maximal number of elements 'Consume' pops at once
+constexpr std::size_t kMaxConsumeBatchSize = 64;
+
+// The state of a single iteration over a 'ConsumedQueue'
+template <typename T> class QueueConsuming {
+ public:
+  explicit QueueConsuming(ConcurrentQueue<T>& queue)
+      : queue_(&queue), batch_(std::min(kMaxConsumeBatchSize, std::max<std::size_t>(1, queue.capacity() / 4))) {}
+
+  const T& Current() {
+    AtEnd();  // Waits for the next batch if the current one has been read
+    return batch_[index_];
+  }
+
+  // True if the queue got closed and drained, waiting for the next batch if needed
+  bool AtEnd() {
+    if (index_ == size_ && !finished_) {
+      index_ = 0;
+      Await([this] {
+        size_ = queue_->TryPopBatch(batch_.begin(), batch_.size());
+        return size_ != 0 || queue_->IsDrained();
+      });
+      finished_ = size_ == 0;
+    }
+    return index_ == size_;
+  }
+
+  void Advance() {
+    AtEnd();
+    index_++;
+  }
+
+ private:
+  ConcurrentQueue<T>* queue_;
+  std::vector<T> batch_;
+  std::size_t size_ = 0;   // The number of elements in 'batch_'
+  std::size_t index_ = 0;  // The position of the current element in 'batch_'
+  bool finished_ = false;
+};
+
+template <typename T> class QueueConsumingIterator {
+ public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const T*;
+  using reference = const T&;
+
+  // The end of every iteration
+  QueueConsumingIterator() = default;
+  explicit QueueConsumingIterator(std::shared_ptr<QueueConsuming<T>> consuming) : consuming_(std::move(consuming)) {}
+
+  reference operator*() const { return consuming_->Current(); }
+  pointer operator->() const { return &**this; }
+
+  QueueConsumingIterator& operator++() {
+    consuming_->Advance();
+    return *this;
+  }
+  void operator++(int) { ++*this; }
+
+  // All iterators of an iteration share their position, so they are only ever compared with the end
+  bool operator==(const QueueConsumingIterator& other) const { return AtEnd() == other.AtEnd(); }
+  bool operator!=(const QueueConsumingIterator& other) const { return !(*this == other); }
+
+ private:
+  bool AtEnd() const { return !consuming_ || consuming_->AtEnd(); }
+
+  std::shared_ptr<QueueConsuming<T>> consuming_{};
+};
+
+}  // namespace details
+
+template <typename T>
+ConcurrentQueue<T>::ConcurrentQueue(std::size_t capacity)
+    : mask_(Capacity(capacity) - 1), slots_(new Slot[mask_ + 1]) {
+  for (std::size_t position = 0; position <= mask_; position++)
+    slots_[position].sequence.store(position, std::memory_order_relaxed);
+}
+
+template <typename T> template <typename U> bool ConcurrentQueue<T>::TryPush(U&& value) {
+  std::size_t position = enqueue_position_.load(std::memory_order_relaxed);
+  while ((position & kClosed) == 0) {
+    Slot& slot = slots_[position & mask_];
+    const std::ptrdiff_t difference = Difference(slot.sequence.load(std::memory_order_acquire), position);
+    if (difference < 0)
+      return false;  // The slot still holds the element pushed one lap earlier, so the queue is full
+    if (difference > 0) {
+      position = enqueue_position_.load(std::memory_order_relaxed);  // Another thread took this position
+    } else if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+      slot.value = std::forward<U>(value);
+      slot.sequence.store(position + 1, std::memory_order_release);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T> template <typename U> bool ConcurrentQueue<T>::Push(U&& value) {
+  bool pushed = false;
+  details::Await([&] {
+    pushed = TryPush(std::forward<U>(value));
+    return pushed || IsClosed();
+  });
+  return pushed;
+}
+
+template <typename T>
+template <typename OutputIterator>
+std::size_t ConcurrentQueue<T>::TryPopBatch(OutputIterator values, std::size_t max_count) {
+  std::size_t position = dequeue_position_.load(std::memory_order_relaxed);
+  std::size_t count = 0;
+  while (true) {
+    const std::ptrdiff_t difference = Difference(slots_[position & mask_].sequence.load(std::memory_order_acquire),
+                                                 position + 1);
+    if (difference < 0)
+      return 0;  // The slot has not been written yet, so the queue is empty
+    if (difference > 0) {
+      position = dequeue_position_.load(std::memory_order_relaxed);  // Another thread took this position
+      continue;
+    }
+    // Claims all the consecutive slots that are ready at once
+    count = 1;
+    while (count < max_count && count <= mask_ &&
+           slots_[(position + count) & mask_].sequence.load(std::memory_order_acquire) == position + count + 1)
+      count++;
+    if (dequeue_position_.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+      break;
+  }
+  for (std::size_t i = 0; i < count; i++, ++values) {
+    Slot& slot = slots_[(position + i) & mask_];
+    *values = std::move(slot.value);
+    // Ready to be written one lap later
+    slot.sequence.store(position + i + mask_ + 1, std::memory_order_release);
+  }
+  return count;
+}
+
+template <typename T> bool ConcurrentQueue<T>::IsDrained() const {
+  const std::size_t enqueue_position = enqueue_position_.load(std::memory_order_acquire);
+  return (enqueue_position & kClosed) != 0 &&
+         dequeue_position_.load(std::memory_order_acquire) == (enqueue_position & ~kClosed);
+}
+
+// Returned by 'Consume'
+template <typename T> class ConsumedQueue : public WithChainedOperators<ConsumedQueue<T>> {
+ public:
+  using value_type = T;
+  using const_iterator = details::QueueConsumingIterator<T>;
+  using iterator = const_iterator;
+
+  explicit ConsumedQueue(ConcurrentQueue<T>& queue) : queue_(&queue) {}
+
+  const_iterator begin() const { return const_iterator{std::make_shared<details::QueueConsuming<T>>(*queue_)}; }
+  const_iterator end() const { return const_iterator{}; }
+
+ private:
+  ConcurrentQueue<T>* queue_;
+};
+
+template <typename T> auto Consume(ConcurrentQueue<T>& queue) { return ConsumedQueue<T>{queue}; }
+
+}  // namespace iterators
+
+#endif  // _CPP_ITERATORS_CONCURRENT_QUEUE_H_
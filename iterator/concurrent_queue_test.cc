@@ -0,0 +1,144 @@
+
+#include "concurrent_queue.h"
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace iterators {
+using std::string;
+using std::vector;
+using testing::ElementsAre;
+
+TEST(ConcurrentQueueTest, PopsInOrder) {
+  ConcurrentQueue<int> queue{8};
+  for (int value = 0; value < 5; value++)
+    EXPECT_TRUE(queue.TryPush(value));
+
+  int value = -1;
+  EXPECT_TRUE(queue.TryPop(value));
+  EXPECT_EQ(0, value);
+  vector<int> values(10);
+  EXPECT_EQ(4, queue.TryPopBatch(values.begin(), values.size()));
+  EXPECT_THAT(vector<int>(values.begin(), values.begin() + 4), ElementsAre(1, 2, 3, 4));
+  EXPECT_FALSE(queue.TryPop(value));
+}
+
+TEST(ConcurrentQueueTest, RoundsCapacityUpAndRejectsPushesOnceFull) {
+  ConcurrentQueue<int> queue{5};
+  EXPECT_EQ(8, queue.capacity());
+  for (int value = 0; value < 8; value++)
+    EXPECT_TRUE(queue.TryPush(value));
+  EXPECT_FALSE(queue.TryPush(8));
+
+  int value = -1;
+  EXPECT_TRUE(queue.TryPop(value));
+  EXPECT_TRUE(queue.TryPush(8));
+}
+
+TEST(ConcurrentQueueTest, KeepsValueIfPushFails) {
+  ConcurrentQueue<std::unique_ptr<int>> queue{1};
+  EXPECT_EQ(2, queue.capacity());
+  EXPECT_TRUE(queue.TryPush(std::make_unique<int>(1)));
+  EXPECT_TRUE(queue.TryPush(std::make_unique<int>(2)));
+  auto value = std::make_unique<int>(2);
+
+  EXPECT_FALSE(queue.TryPush(std::move(value)));
+  ASSERT_NE(nullptr, value);
+  queue.Close();
+  EXPECT_FALSE(queue.Push(std::move(value)));
+  EXPECT_NE(nullptr, value);
+}
+
+TEST(ConcurrentQueueTest, CloseStopsPushesButNotPops) {
+  ConcurrentQueue<string> queue{4};
+  EXPECT_TRUE(queue.Push("a"));
+  queue.Close();
+
+  EXPECT_TRUE(queue.IsClosed());
+  EXPECT_FALSE(queue.IsDrained());
+  EXPECT_FALSE(queue.TryPush("b"));
+  string value{};
+  EXPECT_TRUE(queue.TryPop(value));
+  EXPECT_EQ("a", value);
+  EXPECT_TRUE(queue.IsDrained());
+}
+
+TEST(ConcurrentQueueTest, ConsumeEndsOnceClosedAndDrained) {
+  ConcurrentQueue<int> queue{16};
+  for (int value = 0; value < 10; value++)
+    queue.Push(value);
+  queue.Close();
+
+  vector<int> values{};
+  for (int value : Consume(queue))
+    values.push_back(value);
+  EXPECT_THAT(values, ElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9));
+  EXPECT_EQ(Consume(queue).begin(), Consume(queue).end());
+}
+
+TEST(ConcurrentQueueTest, ConsumeWithChainedOperators) {
+  ConcurrentQueue<int> queue{4};
+  std::thread producer([&queue] {
+    for (int value = 0; value < 100; value++)
+      queue.Push(value);
+    queue.Close();
+  });
+
+  vector<std::pair<int, int>> values{};
+  for (const auto& item : Consume(queue).filter([](int value) { return value % 2 == 1; }).enumerate())
+    values.emplace_back(item.Position(), item.Value() * item.Value());
+  producer.join();
+
+  ASSERT_EQ(50, values.size());
+  EXPECT_EQ(std::make_pair(0, 1), values.front());
+  EXPECT_EQ(std::make_pair(49, 99 * 99), values.back());
+}
+
+TEST(ConcurrentQueueTest, ManyProducersAndConsumers) {
+  constexpr int kProducers = 4;
+  constexpr int kConsumers = 3;
+  constexpr int kValuesPerProducer = 20000;
+  ConcurrentQueue<int> queue{64};
+  std::atomic<int> producing{kProducers};
+  vector<std::thread> producers{};
+  for (int producer = 0; producer < kProducers; producer++) {
+    producers.emplace_back([&, producer] {
+      for (int value = 0; value < kValuesPerProducer; value++)
+        queue.Push(producer * kValuesPerProducer + value);
+      if (--producing == 0)
+        queue.Close();
+    });
+  }
+  vector<vector<int>> consumed(kConsumers);
+  vector<std::thread> consumers{};
+  for (int consumer = 0; consumer < kConsumers; consumer++) {
+    consumers.emplace_back([&, consumer] {
+      for (int value : Consume(queue))
+        consumed[consumer].push_back(value);
+    });
+  }
+  for (auto& thread : producers)
+    thread.join();
+  for (auto& thread : consumers)
+    thread.join();
+
+  // Every value was popped exactly once, and the values of every producer in the order they were pushed
+  vector<int> seen(kProducers * kValuesPerProducer, 0);
+  for (const auto& values : consumed) {
+    vector<int> last(kProducers, -1);
+    for (int value : values) {
+      seen[value]++;
+      EXPECT_LT(last[value / kValuesPerProducer], value);
+      last[value / kValuesPerProducer] = value;
+    }
+  }
+  EXPECT_EQ(vector<int>(kProducers * kValuesPerProducer, 1), seen);
+}
+
+}  // namespace iterators
@@ -0,0 +1,193 @@
+#pragma once
+
+#ifndef _CPP_ITERATORS_FLAT_MAP_H_
+#define _CPP_ITERATORS_FLAT_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace iterators {
+
+// A hash map that stores its entries back-to-back in a std::vector, as returned by 'GroupReduce'.
+//
+// The entries are found through an open-addressing table (with linear probing) of 32-bit indices into that vector,
+// so iterating walks contiguous memory, and a lookup touches the small index table and a single entry.
+// Entries are iterated in the order in which they were inserted, and can not be erased.
+//
+// Simply write this:
+//
+// FlatMap<std::string, int> counts{};
+// counts.Merge("apples", 3, std::plus<int>{});
+// for (const auto& entry : counts)
+//   printf("%s: %d\n", entry.first.c_str(), entry.second);
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatMap {
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const Key, Value>;
+  using iterator = typename std::vector<value_type>::iterator;
+  using const_iterator = typename std::vector<value_type>::const_iterator;
+
+  // 'expected_size' is the number of entries the map can hold before it has to grow
+  explicit FlatMap(std::size_t expected_size = 0, Hash hash = Hash{}, KeyEqual key_equal = KeyEqual{})
+      : hash_(std::move(hash)), key_equal_(std::move(key_equal)) {
+    reserve(expected_size);
+  }
+
+  iterator begin() { return entries_.begin(); }
+  iterator end() { return entries_.end(); }
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+
+  std::size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+  // Makes room for 'size' entries, so inserting them does not need to rehash
+  void reserve(std::size_t size);
+
+  iterator find(const Key& key) { return FindEntry(HashOf(key), key); }
+  const_iterator find(const Key& key) const { return const_cast<FlatMap&>(*this).find(key); }
+  std::size_t count(const Key& key) const { return find(key) == end() ? 0 : 1; }
+
+  // Returns the value of 'key', throws std::out_of_range if there is none
+  Value& at(const Key& key);
+  const Value& at(const Key& key) const { return const_cast<FlatMap&>(*this).at(key); }
+
+  // Returns the value of 'key', inserting a value-initialized one if there is none
+  Value& operator[](const Key& key);
+
+  // Inserts 'value' for 'key', or replaces the current value by 'combine(current value, value)'
+  template <typename Combine> void Merge(Key key, Value value, const Combine& combine) {
+    const std::uint64_t hash = HashOf(key);
+    Merge(hash, std::move(key), std::move(value), combine);
+  }
+  // Same as above, where 'hash' must be 'HashOf(key)' (so the caller can use the hash as well)
+  template <typename Combine> void Merge(std::uint64_t hash, Key key, Value value, const Combine& combine);
+  // Merges all the entries of 'other' into this map, leaving 'other' empty
+  template <typename Combine> void Merge(FlatMap&& other, const Combine& combine);
+
+  // Returns the hash of 'key', mixed so all of its bits depend on all the bits of 'std::hash'
+  // (which simply returns the value of an integer)
+  std::uint64_t HashOf(const Key& key) const {
+    std::uint64_t hash = static_cast<std::uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ull;
+    return hash ^ (hash >> 32);
+  }
+
+ private:
+  // A slot in the index table holds 0 if it is empty, and the position of its entry + 1 otherwise
+  static constexpr std::uint32_t kEmpty = 0;
+
+  iterator FindEntry(std::uint64_t hash, const Key& key);
+  // Adds a new entry for 'key', which must not be in the map yet
+  Value& Insert(std::uint64_t hash, Key key, Value value);
+  void Rehash(std::size_t slots);
+
+  std::vector<std::uint32_t> slots_{};
+  std::vector<value_type> entries_{};
+  std::vector<std::uint64_t> hashes_{};  // The hash of every entry, so rehashing does not need to hash the keys again
+  Hash hash_;
+  KeyEqual key_equal_;
+};
+
+//-----------------------------------------------------------------------------
+// Implementation
+//-----------------------------------------------------------------------------
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+void FlatMap<Key, Value, Hash, KeyEqual>::reserve(std::size_t size) {
+  entries_.reserve(size);
+  hashes_.reserve(size);
+  // Keep at least half of the slots empty, so probing stays short
+  std::size_t slots = 8;
+  while (slots < 2 * size)
+    slots *= 2;
+  if (slots > slots_.size())
+    Rehash(slots);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+auto FlatMap<Key, Value, Hash, KeyEqual>::FindEntry(std::uint64_t hash, const Key& key) -> iterator {
+  const std::size_t mask = slots_.size() - 1;
+  for (std::size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+    const std::uint32_t index = slots_[slot];
+    if (index == kEmpty)
+      return entries_.end();
+    if (hashes_[index - 1] == hash && key_equal_(entries_[index - 1].first, key))
+      return entries_.begin() + (index - 1);
+  }
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+Value& FlatMap<Key, Value, Hash, KeyEqual>::at(const Key& key) {
+  const iterator entry = find(key);
+  if (entry == end())
+    throw std::out_of_range("FlatMap::at: key not found");
+  return entry->second;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+Value& FlatMap<Key, Value, Hash, KeyEqual>::operator[](const Key& key) {
+  const std::uint64_t hash = HashOf(key);
+  const iterator entry = FindEntry(hash, key);
+  if (entry != end())
+    return entry->second;
+  return Insert(hash, key, Value{});
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+template <typename Combine>
+void FlatMap<Key, Value, Hash, KeyEqual>::Merge(std::uint64_t hash, Key key, Value value, const Combine& combine) {
+  const iterator entry = FindEntry(hash, key);
+  if (entry != end())
+    entry->second = combine(std::move(entry->second), std::move(value));
+  else
+    Insert(hash, std::move(key), std::move(value));
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+template <typename Combine>
+void FlatMap<Key, Value, Hash, KeyEqual>::Merge(FlatMap&& other, const Combine& combine) {
+  reserve(size() + other.size());
+  for (std::size_t i = 0; i < other.entries_.size(); i++) {
+    value_type& entry = other.entries_[i];
+    Merge(other.hashes_[i], entry.first, std::move(entry.second), combine);
+  }
+  other.entries_.clear();
+  other.hashes_.clear();
+  other.Rehash(other.slots_.size());
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+Value& FlatMap<Key, Value, Hash, KeyEqual>::Insert(std::uint64_t hash, Key key, Value value) {
+  if (2 * (entries_.size() + 1) > slots_.size())
+    Rehash(2 * slots_.size());
+  entries_.emplace_back(std::move(key), std::move(value));
+  hashes_.push_back(hash);
+  const std::size_t mask = slots_.size() - 1;
+  std::size_t slot = hash & mask;
+  while (slots_[slot] != kEmpty)
+    slot = (slot + 1) & mask;
+  slots_[slot] = static_cast<std::uint32_t>(entries_.size());
+  return entries_.back().second;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+void FlatMap<Key, Value, Hash, KeyEqual>::Rehash(std::size_t slots) {
+  slots_.assign(slots, std::uint32_t{kEmpty});
+  const std::size_t mask = slots - 1;
+  for (std::size_t i = 0; i < hashes_.size(); i++) {
+    std::size_t slot = hashes_[i] & mask;
+    while (slots_[slot] != kEmpty)
+      slot = (slot + 1) & mask;
+    slots_[slot] = static_cast<std::uint32_t>(i + 1);
+  }
+}
+
+}  // namespace iterators
+
+#endif  // _CPP_ITERATORS_FLAT_MAP_H_
@@ -0,0 +1,70 @@
+
+#include "flat_map.h"
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace iterators {
+using std::string;
+using std::vector;
+using testing::ElementsAre;
+using testing::Pair;
+
+TEST(FlatMapTest, MergeInsertsOrCombinesValues) {
+  FlatMap<string, int> map{};
+  map.Merge("a", 1, std::plus<int>{});
+  map.Merge("b", 2, std::plus<int>{});
+  map.Merge("a", 3, std::plus<int>{});
+
+  EXPECT_EQ(2, map.size());
+  EXPECT_EQ(4, map.at("a"));
+  EXPECT_EQ(2, map.at("b"));
+}
+
+TEST(FlatMapTest, IteratesInInsertionOrder) {
+  FlatMap<int, int> map{};
+  for (int key : {5, 3, 9, 3})
+    map[key] += key;
+
+  EXPECT_THAT(map, ElementsAre(Pair(5, 5), Pair(3, 6), Pair(9, 9)));
+}
+
+TEST(FlatMapTest, FindsKeysAfterGrowing) {
+  FlatMap<int, int> map{};
+  for (int key = 0; key < 100000; key++)
+    map[key * 1024] = key;
+
+  EXPECT_EQ(100000, map.size());
+  for (int key = 0; key < 100000; key++)
+    ASSERT_EQ(key, map.at(key * 1024));
+  EXPECT_EQ(map.end(), map.find(1));
+  EXPECT_EQ(0, map.count(1));
+  EXPECT_EQ(1, map.count(1024));
+}
+
+TEST(FlatMapTest, AtThrowsForMissingKey) {
+  const FlatMap<string, int> map{};
+
+  EXPECT_THROW(map.at("missing"), std::out_of_range);
+  EXPECT_TRUE(map.empty());
+}
+
+TEST(FlatMapTest, MergesOtherMap) {
+  FlatMap<string, int> map{};
+  map["a"] = 1;
+  map["b"] = 2;
+  FlatMap<string, int> other{};
+  other["b"] = 10;
+  other["c"] = 20;
+  map.Merge(std::move(other), std::plus<int>{});
+
+  EXPECT_THAT(map, ElementsAre(Pair("a", 1), Pair("b", 12), Pair("c", 20)));
+  EXPECT_TRUE(other.empty());
+  EXPECT_EQ(other.end(), other.find("b"));
+}
+
+}  // namespace iterators
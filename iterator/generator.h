@@ -0,0 +1,245 @@
+#pragma once
+
+#ifndef _CPP_ITERATORS_GENERATOR_H_
+#define _CPP_ITERATORS_GENERATOR_H_
+
+#include "iterators.h"
+
+// Generators are C++20 coroutines, so they are only available when the compiler supports those
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace iterators {
+
+// A lazy collection, whose elements are produced by a coroutine that returns it and 'co_yield's them one by one,
+// so complex traversals (like tree walks or paginated scans) can be written as plain loops instead of iterators.
+//
+// The coroutine only runs while the generator is iterated, and is suspended at every 'co_yield' until the next
+// element is needed. The iterators refer to the yielded object itself, which stays alive while the coroutine is
+// suspended, so yielding (even a temporary) never copies it.
+// 'Generator<const T&>' yields const references, 'Generator<T>' references to a 'T' that may be modified.
+// The coroutine frames are recycled by every thread (see 'details::FramePool'), so short-lived generators
+// rarely allocate.
+//
+// A generator can only be iterated once, and can not be copied (but it can be moved into other operators).
+// An exception thrown by the coroutine is rethrown when the iterator is moved to the next element.
+//
+// Simply write this:
+//
+// Generator<const Node&> Walk(const Node& node) {
+//   for (const Node& child : node.children)
+//     for (const Node& descendant : Walk(child))
+//       co_yield descendant;
+//   co_yield node;
+// }
+// for (const std::string& name : Walk(root).filter(is_leaf).map(name_of))
+//   Print(name);
+template <typename T> class Generator;
+
+//-----------------------------------------------------------------------------
+// Implementation
+//-----------------------------------------------------------------------------
+
+namespace details {
+
+// Recycles coroutine frames: every thread keeps the frames it freed in lists per size class,
+// and hands them out again for frames of the same size class
+class FramePool {
+ public:
+  static void* Allocate(std::size_t size) {
+    const std::size_t size_class = SizeClass(size);
+    if (size_class < kSizeClasses) {
+      Lists& lists = ThreadLists();
+      if (FreeFrame* frame = lists.heads[size_class]) {
+        lists.heads[size_class] = frame->next;
+        lists.counts[size_class]--;
+        return frame;
+      }
+      return ::operator new((size_class + 1) * kGranularity);
+    }
+    return ::operator new(size);
+  }
+
+  static void Free(void* frame, std::size_t size) {
+    const std::size_t size_class = SizeClass(size);
+    if (size_class < kSizeClasses && !ThreadListsDestroyed()) {
+      Lists& lists = ThreadLists();
+      if (lists.counts[size_class] < kMaxFreeFrames) {
+        lists.heads[size_class] = new (frame) FreeFrame{lists.heads[size_class]};
+        lists.counts[size_class]++;
+        return;
+      }
+    }
+    ::operator delete(frame);
+  }
+
+ private:
+  // Frames are rounded up to a multiple of 'kGranularity' bytes, and frames larger than
+  // 'kSizeClasses * kGranularity' bytes are not recycled
+  static constexpr std::size_t kGranularity = 64;
+  static constexpr std::size_t kSizeClasses = 16;
+  // The maximal number of free frames a thread keeps per size class
+  static constexpr std::size_t kMaxFreeFrames = 32;
+
+  struct FreeFrame {
+    FreeFrame* next;
+  };
+
+  struct Lists {
+    FreeFrame* heads[kSizeClasses] = {};
+    std::size_t counts[kSizeClasses] = {};
+
+    ~Lists() {
+      ThreadListsDestroyed() = true;
+      for (FreeFrame* head : heads) {
+        while (head != nullptr)
+          ::operator delete(std::exchange(head, head->next));
+      }
+    }
+  };
+
+  static std::size_t SizeClass(std::size_t size) { return (size + kGranularity - 1) / kGranularity - 1; }
+
+  static Lists& ThreadLists() {
+    thread_local Lists lists{};
+    return lists;
+  }
+  // Frames freed while the thread exits (after its lists have been destroyed) are simply deleted
+  static bool& ThreadListsDestroyed() {
+    thread_local bool destroyed = false;
+    return destroyed;
+  }
+};
+
+template <typename T> class GeneratorPromise {
+ public:
+  using _pointer = std::add_pointer_t<std::remove_reference_t<T>>;
+
+  Generator<T> get_return_object() {
+    return Generator<T>{std::coroutine_handle<GeneratorPromise>::from_promise(*this)};
+  }
+  // Only starts once the generator is iterated
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+  std::suspend_always final_suspend() const noexcept { return {}; }
+
+  std::suspend_always yield_value(std::remove_reference_t<T>& value) noexcept {
+    value_ = std::addressof(value);
+    return {};
+  }
+  // A temporary lives until the coroutine resumes, so it does not need to be copied either
+  std::suspend_always yield_value(std::remove_reference_t<T>&& value) noexcept {
+    value_ = std::addressof(value);
+    return {};
+  }
+  void return_void() const noexcept {}
+  void unhandled_exception() noexcept { error_ = std::current_exception(); }
+  // Disallows 'co_await' in generators
+  template <typename U> std::suspend_never await_transform(U&&) = delete;
+
+  static void* operator new(std::size_t size) { return FramePool::Allocate(size); }
+  static void operator delete(void* frame, std::size_t size) { FramePool::Free(frame, size); }
+
+  _pointer Value() const { return value_; }
+  void RethrowIfFailed() const {
+    if (error_)
+      std::rethrow_exception(error_);
+  }
+
+  // Runs the coroutine up to the first 'co_yield', unless that happened already
+  void Start(std::coroutine_handle<GeneratorPromise> handle) {
+    if (!started_) {
+      started_ = true;
+      handle.resume();
+      RethrowIfFailed();
+    }
+  }
+
+ private:
+  _pointer value_ = nullptr;
+  std::exception_ptr error_{};
+  bool started_ = false;
+};
+
+template <typename T> class GeneratorIterator {
+ public:
+  using _handle = std::coroutine_handle<GeneratorPromise<T>>;
+
+  using iterator_category = std::input_iterator_tag;
+  using value_type = remove_cvref_t<T>;
+  using difference_type = std::ptrdiff_t;
+  using reference = std::conditional_t<std::is_reference<T>::value, T, T&>;
+  using pointer = std::add_pointer_t<reference>;
+
+  // The end of every iteration
+  GeneratorIterator() = default;
+  explicit GeneratorIterator(_handle handle) : handle_(handle) {}
+
+  reference operator*() const { return static_cast<reference>(*handle_.promise().Value()); }
+  pointer operator->() const { return std::addressof(**this); }
+
+  GeneratorIterator& operator++() {
+    handle_.resume();
+    handle_.promise().RethrowIfFailed();
+    return *this;
+  }
+  void operator++(int) { ++*this; }
+
+  // All iterators of a generator share the coroutine, so they are only ever compared with the end
+  bool operator==(const GeneratorIterator& other) const { return AtEnd() == other.AtEnd(); }
+  bool operator!=(const GeneratorIterator& other) const { return !(*this == other); }
+
+ private:
+  bool AtEnd() const { return !handle_ || handle_.done(); }
+
+  _handle handle_{};
+};
+
+}  // namespace details
+
+template <typename T> class Generator : public WithChainedOperators<Generator<T>> {
+ public:
+  using promise_type = details::GeneratorPromise<T>;
+
+  using value_type = details::remove_cvref_t<T>;
+  using const_iterator = details::GeneratorIterator<T>;
+  using iterator = const_iterator;
+
+  Generator(Generator&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+  Generator& operator=(Generator&& other) noexcept {
+    std::swap(handle_, other.handle_);
+    return *this;
+  }
+  ~Generator() {
+    if (handle_)
+      handle_.destroy();
+  }
+
+  // Runs the coroutine up to its first element
+  const_iterator begin() const {
+    if (!handle_)
+      return const_iterator{};
+    handle_.promise().Start(handle_);
+    return const_iterator{handle_};
+  }
+  const_iterator end() const { return const_iterator{}; }
+
+ private:
+  friend promise_type;
+
+  explicit Generator(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+}  // namespace iterators
+
+#endif  // defined(__cpp_impl_coroutine)
+
+#endif  // _CPP_ITERATORS_GENERATOR_H_
@@ -0,0 +1,124 @@
+
+#include "generator.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+#include "benchmark/benchmark.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+namespace iterators {
+namespace {
+
+using Pages = std::vector<std::vector<int>>;
+
+// Pages of varying sizes, some of them empty, like the results of a paginated scan
+Pages MakePages(int count) {
+  Pages result(count);
+  for (int page = 0; page < count; page++) {
+    for (int value = 0; value < page % 97; value++)
+      result[page].push_back(value);
+  }
+  return result;
+}
+
+// What one would write without generators: an iterator over all the values of all the pages
+class PageValueIterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = int;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const int*;
+  using reference = const int&;
+
+  PageValueIterator(Pages::const_iterator page, Pages::const_iterator end) : page_(page), end_(end) {
+    SkipEmptyPages();
+  }
+
+  reference operator*() const { return *value_; }
+  PageValueIterator& operator++() {
+    if (++value_ == page_->end()) {
+      ++page_;
+      SkipEmptyPages();
+    }
+    return *this;
+  }
+
+  bool operator==(const PageValueIterator& other) const {
+    return page_ == other.page_ && (page_ == end_ || value_ == other.value_);
+  }
+  bool operator!=(const PageValueIterator& other) const { return !(*this == other); }
+
+ private:
+  void SkipEmptyPages() {
+    while (page_ != end_ && page_->empty())
+      ++page_;
+    if (page_ != end_)
+      value_ = page_->begin();
+  }
+
+  Pages::const_iterator page_;
+  Pages::const_iterator end_;
+  std::vector<int>::const_iterator value_{};
+};
+
+Generator<const int&> PageValues(const Pages& pages) {
+  for (const auto& page : pages) {
+    for (const int& value : page)
+      co_yield value;
+  }
+}
+
+void BM_Pages_HandwrittenIterator(benchmark::State& state) {
+  const Pages pages = MakePages(4096);
+  const auto elements = static_cast<std::int64_t>(Count(Chain(pages)));
+  for (auto _ : state) {
+    long sum = 0;
+    const PageValueIterator end{pages.end(), pages.end()};
+    for (PageValueIterator it{pages.begin(), pages.end()}; it != end; ++it)
+      sum += *it;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(BM_Pages_HandwrittenIterator);
+
+void BM_Pages_Generator(benchmark::State& state) {
+  const Pages pages = MakePages(4096);
+  const auto elements = static_cast<std::int64_t>(Count(Chain(pages)));
+  for (auto _ : state) {
+    long sum = 0;
+    for (int value : PageValues(pages))
+      sum += value;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(BM_Pages_Generator);
+
+Generator<const int&> FirstValue(const std::vector<int>& page) {
+  if (!page.empty())
+    co_yield page.front();
+}
+
+// A short-lived generator per page, which only yields its first value, so creating the generators dominates:
+// their frames come from the pool of the thread (counts pages, not values)
+void BM_Pages_GeneratorPerPage(benchmark::State& state) {
+  const Pages pages = MakePages(4096);
+  for (auto _ : state) {
+    long sum = 0;
+    for (const auto& page : pages) {
+      for (int value : FirstValue(page))
+        sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(pages.size()));
+}
+BENCHMARK(BM_Pages_GeneratorPerPage);
+
+}  // namespace
+}  // namespace iterators
+#endif  // defined(__cpp_impl_coroutine)
+
+BENCHMARK_MAIN();
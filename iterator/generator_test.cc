@@ -0,0 +1,160 @@
+
+#include "generator.h"
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+namespace iterators {
+using std::string;
+using std::vector;
+using testing::ElementsAre;
+
+Generator<int> Numbers(int begin, int end) {
+  for (int value = begin; value < end; value++)
+    co_yield value;
+}
+
+struct Node {
+  string name;
+  vector<Node> children;
+};
+
+// Yields the children before their parent
+Generator<const Node&> Walk(const Node& node) {
+  for (const Node& child : node.children) {
+    for (const Node& descendant : Walk(child))
+      co_yield descendant;
+  }
+  co_yield node;
+}
+
+template <typename T> vector<typename T::value_type> ToVector(T&& collection) {
+  vector<typename T::value_type> result{};
+  for (auto&& value : collection)
+    result.push_back(value);
+  return result;
+}
+
+TEST(GeneratorTest, YieldsAllElementsLazily) {
+  int produced = 0;
+  auto counting = [&produced]() -> Generator<int> {
+    for (int value = 0; value < 3; value++) {
+      produced++;
+      co_yield value;
+    }
+  };
+
+  auto generator = counting();
+  EXPECT_EQ(0, produced);
+  auto it = generator.begin();
+  EXPECT_EQ(1, produced);
+  EXPECT_EQ(0, *it);
+  ++it;
+  EXPECT_EQ(1, *it);
+  EXPECT_EQ(2, produced);
+  EXPECT_THAT(ToVector(Numbers(0, 5)), ElementsAre(0, 1, 2, 3, 4));
+  EXPECT_THAT(ToVector(Numbers(5, 5)), ElementsAre());
+}
+
+TEST(GeneratorTest, YieldsReferencesWithoutCopying) {
+  vector<std::unique_ptr<int>> values{};
+  values.push_back(std::make_unique<int>(1));
+  values.push_back(std::make_unique<int>(2));
+  auto generator = [](vector<std::unique_ptr<int>>& values) -> Generator<std::unique_ptr<int>&> {
+    for (auto& value : values)
+      co_yield value;
+  }(values);
+
+  vector<const std::unique_ptr<int>*> addresses{};
+  for (auto& value : generator) {
+    addresses.push_back(&value);
+    *value *= 10;
+  }
+  EXPECT_THAT(addresses, ElementsAre(&values[0], &values[1]));
+  EXPECT_EQ(10, *values[0]);
+  EXPECT_EQ(20, *values[1]);
+}
+
+TEST(GeneratorTest, WalksTreeRecursively) {
+  Node root{"root", {Node{"a", {Node{"a1", {}}, Node{"a2", {}}}}, Node{"b", {}}}};
+
+  vector<string> names{};
+  for (const Node& node : Walk(root))
+    names.push_back(node.name);
+  EXPECT_THAT(names, ElementsAre("a1", "a2", "a", "b", "root"));
+}
+
+TEST(GeneratorTest, ChainsWithOtherOperators) {
+  Node root{"root", {Node{"a", {Node{"a1", {}}, Node{"a2", {}}}}, Node{"b", {}}}};
+  auto is_leaf = [](const Node& node) { return node.children.empty(); };
+  auto name_of = [](const Node& node) { return node.name; };
+
+  EXPECT_THAT(ToVector(Walk(root).filter(is_leaf).map(name_of)), ElementsAre("a1", "a2", "b"));
+  vector<std::pair<int, int>> items{};
+  for (const auto& item : Numbers(10, 13).enumerate())
+    items.emplace_back(item.Position(), item.Value());
+  EXPECT_THAT(items, ElementsAre(std::make_pair(0, 10), std::make_pair(1, 11), std::make_pair(2, 12)));
+  EXPECT_EQ(10, Numbers(0, 5).sum());
+}
+
+TEST(GeneratorTest, RethrowsExceptionOfCoroutine) {
+  auto failing = []() -> Generator<int> {
+    co_yield 1;
+    throw std::runtime_error("failed");
+  };
+
+  auto generator = failing();
+  auto it = generator.begin();
+  EXPECT_EQ(1, *it);
+  EXPECT_THROW(++it, std::runtime_error);
+  EXPECT_THROW(
+      {
+        auto failing_at_start = []() -> Generator<int> {
+          throw std::runtime_error("failed");
+          co_return;
+        };
+        auto generator = failing_at_start();
+        generator.begin();
+      },
+      std::runtime_error);
+}
+
+TEST(GeneratorTest, CanBeIteratedAgainOnceCached) {
+  auto numbers = Numbers(0, 3).cache();
+
+  EXPECT_THAT(numbers, ElementsAre(0, 1, 2));
+  EXPECT_THAT(numbers, ElementsAre(0, 1, 2));
+  EXPECT_THAT(Reverse(numbers), ElementsAre(2, 1, 0));
+}
+
+TEST(GeneratorTest, CanBeMovedAndDestroyedBeforeTheEnd) {
+  auto generator = Numbers(0, 1000);
+  auto moved = std::move(generator);
+  auto it = moved.begin();
+  EXPECT_EQ(0, *it);
+  EXPECT_EQ(generator.begin(), generator.end());
+}
+
+TEST(FramePoolTest, RecyclesFramesOfTheSameSizeClass) {
+  void* frame = details::FramePool::Allocate(100);
+  details::FramePool::Free(frame, 100);
+
+  void* recycled = details::FramePool::Allocate(120);
+  EXPECT_EQ(frame, recycled);
+  void* other = details::FramePool::Allocate(100);
+  EXPECT_NE(recycled, other);
+  details::FramePool::Free(recycled, 120);
+  details::FramePool::Free(other, 100);
+
+  // Large frames are not recycled, which simply returns them to the allocator
+  void* large = details::FramePool::Allocate(100000);
+  details::FramePool::Free(large, 100000);
+}
+
+}  // namespace iterators
+#endif  // defined(__cpp_impl_coroutine)
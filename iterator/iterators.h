@@ -3,14 +3,28 @@
 #ifndef _CPP_ITERATORS_ITERATORS_H_
 #define _CPP_ITERATORS_ITERATORS_H_
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <new>
 #include <type_traits>
 #include <utility>
+#include <vector>
+#if __cplusplus >= 202002L
+#include <ranges>
+#include <span>
+#endif
 
 namespace iterators {
 template <typename> class Chained;
 template <typename> class ForwardChained;
+template <typename> class IndexedChained;
 template <typename> class Enumerated;
 template <typename> class ForwardEnumerated;
 template <typename> class Iterated;
@@ -26,8 +40,13 @@ template <typename, typename> class Mapped;
 template <typename, typename> class ForwardMapped;
 template <typename, typename> class Filtered;
 template <typename, typename> class ForwardFiltered;
+template <typename> class Cached;
+template <typename> class BeginCached;
 template <typename, typename> class Zipped;
 template <typename, typename> class ForwardZipped;
+template <typename> class Block;
+template <typename> class Range;
+class ThreadPool;
 
 namespace details {
 
@@ -75,6 +94,17 @@ template <typename T> class has_size {
   enum { value = sizeof(test<T>(nullptr)) == sizeof(one) };
 };
 
+template <typename T> class has_data {
+  typedef char one;
+  typedef long two;
+
+  template <typename C> static one test(decltype(std::declval<remove_cvref_t<C>>().data())*);
+  template <typename C> static two test(...);
+
+ public:
+  enum { value = sizeof(test<T>(nullptr)) == sizeof(one) };
+};
+
 template <typename T1, typename T2> using have_size = conjunction<has_size<T1>, has_size<T2>>;
 
 // True if both the outer and the nested collection support size
@@ -90,6 +120,48 @@ using are_bidirectional_collections = conjunction<is_bidirectional_collection<T1
 template <typename T>
 using is_nested_bidirectional_collection = are_bidirectional_collections<T, typename remove_cvref_t<T>::value_type>;
 
+template <typename T, bool = conjunction<has_data<T>, has_size<T>>::value>
+struct is_contiguous_collection_helper : std::false_type {};
+template <typename T>
+struct is_contiguous_collection_helper<T, true>
+    : std::is_same<remove_cvref_t<decltype(*std::declval<remove_cvref_t<T>>().data())>,
+                   typename remove_cvref_t<T>::value_type> {};
+
+// True if 'T' stores its elements in one contiguous block of memory,
+// e.g. std::vector, std::array, std::string or Iterate(std::vector)
+template <typename T> using is_contiguous_collection = is_contiguous_collection_helper<T>;
+
+template <typename Kernel, typename Out> class BlockKernel;
+
+// True if 'Function' is a kernel passed to 'MapBlocks'
+template <typename Function> struct is_block_kernel : std::false_type {};
+template <typename Kernel, typename Out> struct is_block_kernel<BlockKernel<Kernel, Out>> : std::true_type {};
+
+// True if 2 consecutive mapping-functions can be fused into one
+template <typename F1, typename F2>
+using are_fusable_functions = std::integral_constant<bool, !is_block_kernel<F1>::value && !is_block_kernel<F2>::value>;
+
+// The mapping-functions of 'MapKeys' and 'MapValues': return a const reference into the map entry,
+// or a value if the entry itself is a temporary (e.g. made by another mapping-function)
+struct select_key {
+  template <typename Pair> const typename Pair::first_type& operator()(Pair& pair) const { return pair.first; }
+  template <typename Pair> typename Pair::first_type operator()(Pair&& pair) const { return std::move(pair.first); }
+};
+struct select_value {
+  template <typename Pair> const typename Pair::second_type& operator()(Pair& pair) const { return pair.second; }
+  template <typename Pair> typename Pair::second_type operator()(Pair&& pair) const { return std::move(pair.second); }
+};
+
+// The mapping-function and the filter used by 'FilterMap'
+struct dereference_value {
+  template <typename Optional>
+  remove_cvref_t<decltype(*std::declval<Optional>())> operator()(Optional&& optional) const {
+    return *std::forward<Optional>(optional);
+  }
+};
+struct has_value {
+  template <typename Optional> bool operator()(const Optional& optional) const { return static_cast<bool>(optional); }
+};
 }  // namespace details
 
 // Allows you to enumerate over the elements of a given collection.
@@ -166,6 +238,22 @@ auto Chain(T&& iterable) {
   return ForwardChained<T>{std::forward<T>(iterable)};
 }
 
+// Chains a collection of random-access collections (e.g. the shards of a buffer) like 'Chain' does, but first
+// indexes the position at which every nested collection starts, so the chained elements can be accessed at random.
+//
+// Building the index walks the outer collection once. After that 'size' and the distance between iterators are O(1),
+// while indexing and advancing an iterator are O(log(number of nested collections)). So standard algorithms (like
+// std::lower_bound or std::nth_element) keep their complexity, and 'Parallel' splits the chain by element.
+// The nested collections must not change their sizes while the chain exists.
+//
+// Simply write this:
+//
+// vector<vector<Sample>> shards
+// auto samples = IndexedChain(shards);
+// auto late = std::lower_bound(samples.begin(), samples.end(), deadline, is_earlier);
+// Log(samples[samples.size() / 2]);
+template <typename T> auto IndexedChain(T&& iterable) { return IndexedChained<T>{std::forward<T>(iterable)}; }
+
 // Allows you to iterate over a collection of pointers using references
 //
 // This is a nice way to hide how you internally store your objects.
@@ -223,6 +311,8 @@ template <typename T> auto Reverse(T&& iterable) {
                 "Can only reverse collections that have bidirectional iterators");
   return Reversed<T>{std::forward<T>(iterable)};
 }
+// Reversing a reversed collection simply iterates the original collection
+template <typename T> auto Reverse(Reversed<T>&& reversed) { return std::move(reversed).Unreverse(); }
 
 // Allows you to iterate over 2 collections.
 // First we'll walk the elements of the first collection,
@@ -267,17 +357,25 @@ template <typename T, typename Function,
 auto Map(T&& data, Function mapping_function) {
   return ForwardMapped<T, Function>(std::forward<T>(data), std::forward<Function>(mapping_function));
 }
-
-// Iterates over the keys of a std::map
-template <typename T> auto MapKeys(T&& map) {
-  return Map(std::forward<T>(map), [](const auto& map_pair) { return map_pair.first; });
+// Mapping a mapped collection applies both mapping-functions in a single step
+// (unless either is a block kernel, as those must keep processing whole blocks).
+template <typename T, typename F, typename Function,
+          typename details::enable_if_t<details::are_fusable_functions<F, Function>::value, int> = 1>
+auto Map(Mapped<T, F>&& data, Function mapping_function) {
+  return std::move(data).ThenMap(std::move(mapping_function));
 }
-
-// Iterates over the values of a std::map
-template <typename T> auto MapValues(T&& map) {
-  return Map(std::forward<T>(map), [](const auto& map_pair) { return map_pair.second; });
+template <typename T, typename F, typename Function,
+          typename details::enable_if_t<details::are_fusable_functions<F, Function>::value, int> = 1>
+auto Map(ForwardMapped<T, F>&& data, Function mapping_function) {
+  return std::move(data).ThenMap(std::move(mapping_function));
 }
 
+// Iterates over the keys of a std::map (as const references, so they are not copied)
+template <typename T> auto MapKeys(T&& map) { return Map(std::forward<T>(map), details::select_key{}); }
+
+// Iterates over the values of a std::map (as const references, so they are not copied)
+template <typename T> auto MapValues(T&& map) { return Map(std::forward<T>(map), details::select_value{}); }
+
 // Returns an iterator over the elements for which filter(element) returns 'true'
 template <typename T, typename FilterFunction,
           typename details::enable_if_t<details::is_bidirectional_collection<T>::value, int> = 1>
@@ -289,6 +387,59 @@ template <typename T, typename FilterFunction,
 auto Filter(T&& data, FilterFunction filter) {
   return ForwardFiltered<T, FilterFunction>(std::forward<T>(data), std::forward<FilterFunction>(filter));
 }
+// Filtering a filtered collection checks both filters in a single pass
+template <typename T, typename F, typename FilterFunction> auto Filter(Filtered<T, F>&& data, FilterFunction filter) {
+  return std::move(data).ThenFilter(std::move(filter));
+}
+template <typename T, typename F, typename FilterFunction>
+auto Filter(ForwardFiltered<T, F>&& data, FilterFunction filter) {
+  return std::move(data).ThenFilter(std::move(filter));
+}
+
+// Applies the mapping-function to all the items, and iterates over the results that hold a value.
+// The mapping-function returns an optional value (e.g. a std::optional), and is called only once per item,
+// so this is cheaper than mapping and filtering when the mapping-function is expensive (e.g. parsing).
+//
+// Simply write this:
+//
+// for (const Order& order : FilterMap(lines, [](const std::string& line) { return ParseOrder(line); }))
+// {
+//       // do-something
+// }
+//
+template <typename T, typename Function> auto FilterMap(T&& data, Function mapping_function) {
+  return Map(Filter(Map(std::forward<T>(data), std::move(mapping_function)), details::has_value{}),
+             details::dereference_value{});
+}
+
+// Remembers the elements of a collection the first time they are iterated, so iterating it again (in either direction)
+// returns the remembered elements instead of computing them again (e.g. with an expensive mapping-function).
+//
+// The elements are only computed as far as they are iterated, and stored in chunks that are never moved, so they
+// are returned by const reference. A single-pass collection (like a Generator) can be iterated several times this
+// way. Asking for the size (or iterating in reverse) computes all the elements.
+// The elements are shared by all copies, which must not be iterated by several threads at the same time.
+//
+// Simply write this:
+//
+// auto prices = Map(orders, ComputePrice).cache();
+// if (prices.size() > kMaxOrders) Log(prices);
+// Charge(prices);
+template <typename T> auto Cache(T&& iterable) { return Cached<T>{std::forward<T>(iterable)}; }
+
+// A const view of a collection that remembers where it begins and its size once they are computed (like
+// std::ranges::filter_view remembers its begin), so checking 'empty()' before iterating a selective 'Filter' (or a
+// 'Chain' of mostly empty collections) does not search for the first element twice.
+//
+// Nothing is remembered by 'Filter' or 'Chain' themselves, since they can not tell when their nested collection
+// changes: only use this view while the collection does not change. Like 'Cache', it must not be used by several
+// threads at the same time.
+//
+// Simply write this:
+//
+// const auto recent = Filter(events, IsRecent).cache_begin();
+// if (!recent.empty()) Report(recent);
+template <typename T> auto CacheBegin(T&& iterable) { return BeginCached<T>{std::forward<T>(iterable)}; }
 
 // Creates tuples of the elements in both collections.
 //
@@ -317,6 +468,110 @@ auto Zip(T1&& iterable_1, T2&& iterable_2) {
   return ForwardZipped<T1, T2>{std::forward<T1>(iterable_1), std::forward<T2>(iterable_2)};
 }
 
+// Calls 'sink(element)' for every element of the collection.
+//
+// Unlike a range-based for loop, this lets every operator drive its nested collection with its own tight loop,
+// e.g. Chain becomes a plain double loop and Join becomes two loops back-to-back,
+// which avoids the per-element bookkeeping of the iterators.
+//
+// Simply write this:
+//
+// ForEach(Chain(collection_of_lists).filter(is_odd), [](int value) { printf("%d\n", value); });
+//
+// or this:
+//
+// Chain(collection_of_lists).filter(is_odd).for_each([](int value) { printf("%d\n", value); });
+template <typename T, typename Sink> void ForEach(T&& iterable, Sink sink);
+
+// The maximum number of elements handed out at once by 'ForEachBlock'
+constexpr std::size_t kBlockSize = 1024;
+
+// Calls 'sink(block)' for consecutive blocks of (at most 'kBlockSize') elements of the collection,
+// where 'block' is a 'Block<const value_type>' that supports 'data()', 'size()', 'operator[]' and iterating.
+//
+// Every operator processes a whole block before handing it on to the next one:
+// Filter computes which elements to keep without branching, and Map runs a tight loop over the block
+// that the compiler can vectorize (using AVX2 or SSE4.2 if the CPU supports it).
+// Blocks of contiguous collections (like std::vector) point straight into the collection.
+//
+// Simply write this:
+//
+// ForEachBlock(Iterate(values).filter(is_valid).map(scale), [&](const auto& block) { sum += Sum(block); });
+template <typename T, typename BlockSink> void ForEachBlock(T&& iterable, BlockSink sink);
+
+// Like 'Map', but the kernel processes a whole block at once,
+// writing 'output[i]' for every 'input[i]' (where 'input' is a 'Block<const In>' and 'output' a 'Block<Out>').
+// This lets you hand-write (or vectorize) the loop, while 'ForEachBlock' calls the kernel once per block.
+//
+// Simply write this:
+//
+// auto doubled = MapBlocks<float>(values, [](auto input, auto output) {
+//   for (std::size_t i = 0; i < input.size(); i++) output[i] = input[i] * 2;
+// });
+template <typename Out, typename T, typename Kernel> auto MapBlocks(T&& iterable, Kernel kernel);
+
+// Copies all the elements of the collection to the output iterator, and returns the end of the written range.
+//
+// If the collection stores its elements contiguously (e.g. a std::vector or Iterate(std::vector)),
+// the elements are trivially copyable and the output is a pointer, this is done with a single memcpy.
+template <typename T, typename OutputIterator> OutputIterator Copy(const T& iterable, OutputIterator output);
+
+// Returns true if both collections contain the same elements in the same order.
+//
+// If both collections store their elements contiguously and the elements can be compared byte-wise
+// (e.g. integers or pointers), this is done with a single memcmp.
+template <typename T1, typename T2> bool Equal(const T1& iterable_1, const T2& iterable_2);
+
+// Returns a hash over all the elements of the collection.
+//
+// Collections containing the same elements hash to the same value, regardless of their storage,
+// so Hash(std::vector<int>) == Hash(std::list<int>) if both contain the same values.
+// Contiguous collections of byte-wise comparable elements are hashed a word at a time.
+template <typename T> std::size_t Hash(const T& iterable);
+
+// Runs the terminal operations of a random-access collection on all cores (defined in parallel.h)
+template <typename T> auto Parallel(T&& iterable);
+template <typename T> auto Parallel(T&& iterable, ThreadPool& pool);
+
+// Maps the elements with up to 'concurrency' calls of a slow function in flight, in order (defined in parallel.h)
+template <typename T, typename Function> auto MapConcurrent(T&& iterable, Function function, std::size_t concurrency);
+
+// Iterates over a collection on a thread of its own, buffering up to 'capacity' elements (defined in parallel.h)
+template <typename T> auto AsyncBuffer(T&& iterable, std::size_t capacity);
+
+// Returns the sum of all the elements of the collection (a value-initialized element if it is empty).
+// The sum has the type of 'element + element', so small integers (like 'std::uint8_t') are summed as 'int'.
+//
+// Collections of arithmetic values that store their elements contiguously or hand them out in blocks
+// (see 'ForEachBlock') are summed with several independent accumulators, so the compiler can vectorize the loop.
+// Note that this changes the order in which floating point values are added,
+// so the result can differ slightly from adding them one by one.
+//
+// Simply write this:
+//
+// double total = Sum(Map(orders, [](const Order& order) { return order.price; }));
+template <typename T> auto Sum(const T& iterable);
+
+// Returns the smallest (or largest) element of the collection (a value-initialized element if it is empty).
+// Just like std::min and std::max, the first of several equal elements is returned.
+template <typename T> auto Min(const T& iterable);
+template <typename T> auto Max(const T& iterable);
+
+// Returns both the smallest and the largest element of the collection as a std::pair, in a single pass.
+template <typename T> auto MinMax(const T& iterable);
+
+// Returns the number of elements in the collection, without iterating it if it knows its size.
+template <typename T> std::size_t Count(const T& iterable);
+
+// Returns 'function(... function(function(init, element_0), element_1) ..., element_n)'
+//
+// Simply write this:
+//
+// std::string csv = Fold(names, std::string{}, [](std::string result, const std::string& name) {
+//   return result.empty() ? name : result + "," + name;
+// });
+template <typename T, typename Value, typename Function> Value Fold(const T& iterable, Value init, Function function);
+
 //-----------------------------------------------------------------------------
 // Implementation
 //-----------------------------------------------------------------------------
@@ -336,6 +591,442 @@ template <typename _Container> constexpr auto rend(_Container& container) { retu
 template <typename _Container> constexpr auto rend(const _Container& container) { return container.rend(); }
 template <typename _Container> constexpr auto crbegin(const _Container& container) { return container.rbegin(); }
 template <typename _Container> constexpr auto crend(const _Container& container) { return container.rend(); }
+template <typename T> constexpr const T& as_const(T& value) { return value; }
+
+// Stores a reference to a collection as a pointer, so the class holding it can be assigned to.
+// A const 'StoredReference' only hands out const iterators, just like a const collection would.
+template <typename T> class StoredReference {
+ public:
+  explicit StoredReference(T& collection) : collection_(&collection) {}
+
+  auto begin() { return std::begin(*collection_); }
+  auto end() { return std::end(*collection_); }
+  auto begin() const { return details::cbegin(*collection_); }
+  auto end() const { return details::cend(*collection_); }
+  auto rbegin() { return collection_->rbegin(); }
+  auto rend() { return collection_->rend(); }
+  auto rbegin() const { return details::crbegin(*collection_); }
+  auto rend() const { return details::crend(*collection_); }
+
+  auto size() const { return collection_->size(); }
+  bool empty() const { return collection_->empty(); }
+  auto data() { return collection_->data(); }
+  auto data() const { return static_cast<const T&>(*collection_).data(); }
+
+  template <typename Sink> void ForEachElement(Sink& sink);
+  template <typename Sink> void ForEachElement(Sink& sink) const;
+  template <typename BlockSink> void ForEachBlockElement(BlockSink& sink) const;
+
+  T& Get() { return *collection_; }
+  const T& Get() const { return *collection_; }
+
+ private:
+  T* collection_;
+};
+
+// The type used to store a collection of type 'T' inside our iterable classes:
+// collections passed by reference are stored as a 'StoredReference', the others are stored by value.
+template <typename T> struct stored {
+  using type = T;
+
+  static T&& Release(type& value) { return std::move(value); }
+};
+template <typename T> struct stored<T&> {
+  using type = StoredReference<T>;
+
+  static T& Release(type& value) { return value.Get(); }
+};
+template <typename T> using stored_t = typename stored<T>::type;
+
+// Returns the collection stored in 'value' so it can be passed on (as 'T&&') to a new iterable class
+template <typename T> T&& release_stored(stored_t<T>& value) { return stored<T>::Release(value); }
+
+// Wraps a function object so it can be assigned to,
+// even if it is a lambda with captures (which has no assignment operator).
+template <typename Function> class AssignableFunction {
+ public:
+  explicit AssignableFunction(Function function) { new (&storage_) Function(std::move(function)); }
+  AssignableFunction(const AssignableFunction& other) { new (&storage_) Function(other.Get()); }
+  AssignableFunction(AssignableFunction&& other) { new (&storage_) Function(std::move(other.Get())); }
+  ~AssignableFunction() { Get().~Function(); }
+
+  AssignableFunction& operator=(const AssignableFunction& other) {
+    if (this != &other) {
+      Get().~Function();
+      new (&storage_) Function(other.Get());
+    }
+    return *this;
+  }
+  AssignableFunction& operator=(AssignableFunction&& other) {
+    if (this != &other) {
+      Get().~Function();
+      new (&storage_) Function(std::move(other.Get()));
+    }
+    return *this;
+  }
+
+  template <typename... Args> decltype(auto) operator()(Args&&... args) const {
+    return Get()(std::forward<Args>(args)...);
+  }
+
+ private:
+  Function& Get() { return *reinterpret_cast<Function*>(&storage_); }
+  const Function& Get() const { return *reinterpret_cast<const Function*>(&storage_); }
+
+  typename std::aligned_storage<sizeof(Function), alignof(Function)>::type storage_;
+};
+
+// The type used to store a function of type 'Function' inside our iterable classes.
+template <typename Function>
+using assignable_function_t = conditional_t<std::is_copy_assignable<Function>::value, Function,
+                                            AssignableFunction<remove_cvref_t<Function>>>;
+
+// Holds a value that can be replaced (or be absent), even if 'T' has no default constructor or assignment operator
+// (like std::optional, which is not available in C++14)
+template <typename T, bool = std::is_trivially_destructible<T>::value && std::is_trivially_copy_assignable<T>::value &&
+                             std::is_default_constructible<T>::value>
+class CachedValue {
+ public:
+  CachedValue() = default;
+  CachedValue(const CachedValue& other) {
+    if (other.has_value_)
+      Emplace(other.Get());
+  }
+  ~CachedValue() { Reset(); }
+
+  CachedValue& operator=(const CachedValue& other) {
+    if (this != &other) {
+      Reset();
+      if (other.has_value_)
+        Emplace(other.Get());
+    }
+    return *this;
+  }
+
+  template <typename Value> void Emplace(Value&& value) {
+    Reset();
+    new (&storage_) T(std::forward<Value>(value));
+    has_value_ = true;
+  }
+  void Reset() {
+    if (has_value_)
+      Get().~T();
+    has_value_ = false;
+  }
+
+  T& Get() { return *reinterpret_cast<T*>(&storage_); }
+  const T& Get() const { return *reinterpret_cast<const T*>(&storage_); }
+
+ private:
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_;
+  bool has_value_ = false;
+};
+// Trivial values (like numbers) are simply overwritten, so they need no flag
+template <typename T> class CachedValue<T, true> {
+ public:
+  template <typename Value> void Emplace(Value&& value) { value_ = std::forward<Value>(value); }
+  void Reset() {}
+
+  T& Get() { return value_; }
+  const T& Get() const { return value_; }
+
+ private:
+  T value_{};
+};
+
+// Used instead of a 'CachedValue' by iterators that do not need to keep a copy of their current element
+struct no_cache {};
+
+// The copy of its current element kept by the iterator of 'Filter', which returns elements of type '_reference':
+// references are cheap to get again, and elements that can not be copied are computed again
+template <typename _reference>
+using filter_cache_t = conditional_t<!std::is_reference<_reference>::value &&
+                                         std::is_copy_constructible<remove_cvref_t<_reference>>::value,
+                                     CachedValue<remove_cvref_t<_reference>>, no_cache>;
+
+
+// Calls 'second(first(value))', used to fuse 2 consecutive mapping-functions
+template <typename First, typename Second> class ComposedFunction {
+ public:
+  ComposedFunction(First first, Second second) : first_(std::move(first)), second_(std::move(second)) {}
+
+  template <typename Value> decltype(auto) operator()(Value&& value) const {
+    return second_(first_(std::forward<Value>(value)));
+  }
+
+ private:
+  assignable_function_t<First> first_;
+  assignable_function_t<Second> second_;
+};
+
+// Returns 'first(value) && second(value)', used to merge 2 consecutive filters
+template <typename First, typename Second> class ConjunctionFunction {
+ public:
+  ConjunctionFunction(First first, Second second) : first_(std::move(first)), second_(std::move(second)) {}
+
+  template <typename Value> bool operator()(const Value& value) const { return first_(value) && second_(value); }
+
+ private:
+  assignable_function_t<First> first_;
+  assignable_function_t<Second> second_;
+};
+
+// Returned by 'operator->' of iterators that return their values by value,
+// as there is no object we could return a pointer to.
+template <typename T> class ArrowProxy {
+ public:
+  explicit ArrowProxy(T value) : value_(std::move(value)) {}
+
+  T* operator->() { return &value_; }
+
+ private:
+  T value_;
+};
+
+// Implements 'operator->' for an iterator whose 'operator*' returns '_reference'.
+template <typename _reference, bool = std::is_reference<_reference>::value> struct arrow_operator {
+  using pointer = remove_reference_t<_reference>*;
+
+  static pointer Apply(_reference value) { return std::addressof(value); }
+};
+template <typename _value> struct arrow_operator<_value, false> {
+  using pointer = ArrowProxy<_value>;
+
+  static pointer Apply(_value value) { return pointer{std::move(value)}; }
+};
+template <typename _reference> using arrow_pointer_t = typename arrow_operator<_reference>::pointer;
+
+// Tells an iterator how to walk a collection it does not own (forward or in reverse).
+// Used instead of storing function pointers, so the iterators stay small.
+struct forward_access {
+  template <typename _Container> static auto Begin(_Container& container) { return std::begin(container); }
+  template <typename _Container> static auto End(_Container& container) { return std::end(container); }
+};
+struct reverse_access {
+  template <typename _Container> static auto Begin(_Container& container) { return details::rbegin(container); }
+  template <typename _Container> static auto End(_Container& container) { return details::rend(container); }
+};
+
+// Returns 'value' as a const reference if 'kConst' is true
+template <bool kConst> struct const_if {
+  template <typename T> static T& Apply(T& value) { return value; }
+};
+template <> struct const_if<true> {
+  template <typename T> static const T& Apply(T& value) { return value; }
+};
+
+// A sink that accepts anything, used to detect 'ForEachElement'
+struct any_sink {
+  template <typename... Args> void operator()(Args&&...) const {}
+};
+
+// True if 'T' drives its own loop through 'ForEachElement(sink)'
+template <typename T> class has_for_each_element {
+  typedef char one;
+  typedef long two;
+
+  template <typename C> static one test(decltype(std::declval<C&>().ForEachElement(std::declval<any_sink&>()))*);
+  template <typename C> static two test(...);
+
+ public:
+  enum { value = sizeof(test<T>(nullptr)) == sizeof(one) };
+};
+
+template <typename T, typename Sink> void ForEach(T& iterable, Sink& sink, std::true_type /* has_for_each_element */) {
+  iterable.ForEachElement(sink);
+}
+template <typename T, typename Sink> void ForEach(T& iterable, Sink& sink, std::false_type /* has_for_each_element */) {
+  for (auto&& value : iterable)
+    sink(std::forward<decltype(value)>(value));
+}
+
+// Calls 'sink(element)' for every element of 'iterable',
+// letting our own collections drive the loop and falling back to a range-based for loop for all others.
+template <typename T, typename Sink> void ForEach(T& iterable, Sink& sink) {
+  details::ForEach(iterable, sink, std::integral_constant<bool, has_for_each_element<T>::value>{});
+}
+
+template <typename T> template <typename Sink> void StoredReference<T>::ForEachElement(Sink& sink) {
+  details::ForEach(*collection_, sink);
+}
+template <typename T> template <typename Sink> void StoredReference<T>::ForEachElement(Sink& sink) const {
+  details::ForEach(static_cast<const T&>(*collection_), sink);
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define _CPP_ITERATORS_X86_DISPATCH 1
+#endif
+
+enum class simd_level { kScalar, kSse42, kAvx2 };
+
+inline simd_level DetectSimdLevel() {
+#if defined(_CPP_ITERATORS_X86_DISPATCH)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return simd_level::kAvx2;
+  if (__builtin_cpu_supports("sse4.2"))
+    return simd_level::kSse42;
+#endif
+  return simd_level::kScalar;
+}
+
+// The best instruction set supported by the CPU we're running on (detected only once)
+inline simd_level CurrentSimdLevel() {
+  static const simd_level level = DetectSimdLevel();
+  return level;
+}
+
+#if defined(_CPP_ITERATORS_X86_DISPATCH)
+// 'flatten' inlines the kernel (and everything it calls), so its loops are compiled for the given instruction set
+template <typename Kernel> __attribute__((target("avx2"), flatten)) void RunAvx2(const Kernel& kernel) { kernel(); }
+template <typename Kernel> __attribute__((target("sse4.2"), flatten)) void RunSse42(const Kernel& kernel) {
+  kernel();
+}
+#endif
+
+// Runs 'kernel()' compiled for the best instruction set the CPU supports.
+// Only worth it for loops over arithmetic values, the others simply run 'kernel()'.
+template <typename Kernel> void RunVectorized(const Kernel& kernel, std::true_type /* is_arithmetic */) {
+#if defined(_CPP_ITERATORS_X86_DISPATCH)
+  switch (CurrentSimdLevel()) {
+    case simd_level::kAvx2:
+      return RunAvx2(kernel);
+    case simd_level::kSse42:
+      return RunSse42(kernel);
+    case simd_level::kScalar:
+      break;
+  }
+#endif
+  kernel();
+}
+template <typename Kernel> void RunVectorized(const Kernel& kernel, std::false_type /* is_arithmetic */) { kernel(); }
+
+// The type of the values in the blocks handed out for collection 'T'
+template <typename T> using block_value_t = remove_cvref_t<decltype(*std::begin(std::declval<const T&>()))>;
+
+// True if 'T' drives its own blocks through 'ForEachBlockElement(sink)'
+template <typename T> class has_for_each_block {
+  typedef char one;
+  typedef long two;
+
+  template <typename C>
+  static one test(decltype(std::declval<const C&>().ForEachBlockElement(std::declval<any_sink&>()))*);
+  template <typename C> static two test(...);
+
+ public:
+  enum { value = sizeof(test<T>(nullptr)) == sizeof(one) };
+};
+
+// Hands out the elements of a contiguous collection as blocks pointing straight into the collection
+template <typename T, typename BlockSink>
+void ForEachBlockOf(const T& iterable, BlockSink& sink, std::true_type /* is_contiguous_collection */) {
+  using _value = block_value_t<T>;
+  const _value* data = iterable.data();
+  const std::size_t size = iterable.size();
+  for (std::size_t offset = 0; offset < size; offset += kBlockSize)
+    sink(Block<const _value>{data + offset, std::min(kBlockSize, size - offset)});
+}
+// Copies the elements of any other collection into blocks
+template <typename T, typename BlockSink>
+void ForEachBlockOf(const T& iterable, BlockSink& sink, std::false_type /* is_contiguous_collection */) {
+  using _value = block_value_t<T>;
+  std::vector<_value> buffer{};
+  buffer.reserve(kBlockSize);
+  auto gather = [&buffer, &sink](const auto& value) {
+    buffer.push_back(value);
+    if (buffer.size() == kBlockSize) {
+      sink(Block<const _value>{buffer.data(), buffer.size()});
+      buffer.clear();
+    }
+  };
+  details::ForEach(iterable, gather);
+  if (!buffer.empty())
+    sink(Block<const _value>{buffer.data(), buffer.size()});
+}
+
+template <typename T, typename BlockSink>
+void ForEachBlock(const T& iterable, BlockSink& sink, std::true_type /* has_for_each_block */) {
+  iterable.ForEachBlockElement(sink);
+}
+template <typename T, typename BlockSink>
+void ForEachBlock(const T& iterable, BlockSink& sink, std::false_type /* has_for_each_block */) {
+  details::ForEachBlockOf(iterable, sink, std::integral_constant<bool, is_contiguous_collection<T>::value>{});
+}
+
+// Calls 'sink(block)' for consecutive blocks of the elements of 'iterable',
+// letting our own collections process the blocks and copying the elements of all others in blocks.
+template <typename T, typename BlockSink> void ForEachBlock(const T& iterable, BlockSink& sink) {
+  details::ForEachBlock(iterable, sink, std::integral_constant<bool, has_for_each_block<T>::value>{});
+}
+
+template <typename T>
+template <typename BlockSink>
+void StoredReference<T>::ForEachBlockElement(BlockSink& sink) const {
+  details::ForEachBlock(static_cast<const T&>(*collection_), sink);
+}
+
+// Wraps the kernel passed to 'MapBlocks'.
+// Besides being called for a whole block, it can be called for a single value so it works like any mapping-function.
+template <typename Kernel, typename Out> class BlockKernel {
+ public:
+  explicit BlockKernel(Kernel kernel) : kernel_(std::move(kernel)) {}
+
+  template <typename In> Out operator()(const In& value) const {
+    Out result{};
+    kernel_(Block<const In>{&value, 1}, Block<Out>{&result, 1});
+    return result;
+  }
+
+  template <typename In> void operator()(Block<const In> input, Block<Out> output) const { kernel_(input, output); }
+
+ private:
+  assignable_function_t<Kernel> kernel_;
+};
+
+// Writes 'output[i] = function(input[i])' for all values in the block
+template <typename Function, typename In, typename Out>
+void MapBlock(const Function& function, Block<const In> input, Block<Out> output,
+              std::true_type /* is_block_kernel */) {
+  function(input, output);
+}
+template <typename Function, typename In, typename Out>
+void MapBlock(const Function& function, Block<const In> input, Block<Out> output,
+              std::false_type /* is_block_kernel */) {
+  const In* in = input.data();
+  Out* out = output.data();
+  const std::size_t size = input.size();
+  auto kernel = [&function, in, out, size]() {
+    for (std::size_t i = 0; i < size; i++)
+      out[i] = function(in[i]);
+  };
+  details::RunVectorized(kernel, std::integral_constant<bool, std::is_arithmetic<In>::value &&
+                                                                    std::is_arithmetic<Out>::value>{});
+}
+
+// Stores the positions of the values for which 'filter(value)' is true in 'selection', and returns how many there are.
+// This does not branch on the outcome of the filter, so it does not suffer from branch mispredictions.
+template <typename Function, typename Value>
+std::size_t SelectBlock(const Function& filter, Block<const Value> input, std::uint16_t* selection) {
+  const Value* in = input.data();
+  const std::size_t size = input.size();
+  std::size_t count = 0;
+  auto kernel = [&filter, &count, in, size, selection]() {
+    std::size_t selected = 0;
+    for (std::size_t i = 0; i < size; i++) {
+      selection[selected] = static_cast<std::uint16_t>(i);
+      selected += static_cast<bool>(filter(in[i]));
+    }
+    count = selected;
+  };
+  details::RunVectorized(kernel, std::integral_constant<bool, std::is_arithmetic<Value>::value>{});
+  return count;
+}
+
+#if defined(__cpp_lib_ranges)
+using view_base = std::ranges::view_base;
+#else
+struct view_base {};
+#endif
 
 // Note: 'std::is_const' is pretty strict, e.g. 'std::is_const<const int&>' returns 'false'.
 //       So we're using this construct that checks if it is const in any way
@@ -351,6 +1042,31 @@ template <typename T> struct is_const_type<const T*&&> : std::true_type {};
 // True if T1 or T2 is const
 template <typename T1, typename T2> using is_any_const = disjunction<is_const_type<T1>, is_const_type<T2>>;
 
+template <typename _iterator> using iterator_category_t = typename std::iterator_traits<_iterator>::iterator_category;
+template <typename _iterator>
+using is_bidirectional_iterator = std::is_base_of<std::bidirectional_iterator_tag, iterator_category_t<_iterator>>;
+template <typename _iterator>
+using is_forward_iterator = std::is_base_of<std::forward_iterator_tag, iterator_category_t<_iterator>>;
+template <typename _iterator>
+using is_random_access_iterator = std::is_base_of<std::random_access_iterator_tag, iterator_category_t<_iterator>>;
+
+// Returns the least capable of both iterator categories,
+// e.g. common_iterator_category_t<random_access_iterator_tag, forward_iterator_tag> --> forward_iterator_tag
+template <typename C1, typename C2>
+using common_iterator_category_t = conditional_t<std::is_base_of<C1, C2>::value, C1, C2>;
+
+// Returns the number of elements of a bidirectional collection without walking it:
+// random-access collections subtract their iterators, all others must support 'size()'.
+template <typename T> int bidirectional_size(T& collection, std::random_access_iterator_tag) {
+  return static_cast<int>(std::end(collection) - std::begin(collection));
+}
+template <typename T> int bidirectional_size(T& collection, std::bidirectional_iterator_tag) {
+  return static_cast<int>(collection.size());
+}
+template <typename T> int bidirectional_size(T& collection) {
+  return bidirectional_size(collection, iterator_category_t<decltype(std::begin(collection))>{});
+}
+
 // The collection type is considered const if:
 //   - it is 'const T'
 //   - its non-const iterator returns a const value
@@ -375,6 +1091,85 @@ using non_const_reverse_iterator_t =
     conditional_t<is_const_type<T>::value, typename remove_cvref_t<T>::const_reverse_iterator,
                   typename remove_cvref_t<T>::reverse_iterator>;
 
+// True if 'T' is one of our classes that splits itself in 2 halves (see 'split_at')
+template <typename T> class has_split_at {
+  typedef char one;
+  typedef long two;
+
+  template <typename C> static one test(decltype(std::declval<C&>().split_at(std::size_t{0}))*);
+  template <typename C> static two test(...);
+
+ public:
+  enum { value = sizeof(test<T>(nullptr)) == sizeof(one) };
+};
+
+// True if splitting 'T' at position 'n' puts exactly its first 'n' elements in the first half.
+// Filters and chains are split at a position of their nested (outer) collection instead.
+template <typename T> struct splits_by_element : std::true_type {};
+template <typename T, typename F> struct splits_by_element<Filtered<T, F>> : std::false_type {};
+template <typename T, typename F> struct splits_by_element<ForwardFiltered<T, F>> : std::false_type {};
+template <typename T> struct splits_by_element<Chained<T>> : std::false_type {};
+template <typename T> struct splits_by_element<ForwardChained<T>> : std::false_type {};
+template <typename T> struct splits_by_element<Iterated<T>> : splits_by_element<remove_cvref_t<T>> {};
+template <typename T> struct splits_by_element<ForwardIterated<T>> : splits_by_element<remove_cvref_t<T>> {};
+template <typename T> struct splits_by_element<Enumerated<T>> : splits_by_element<remove_cvref_t<T>> {};
+template <typename T> struct splits_by_element<ForwardEnumerated<T>> : splits_by_element<remove_cvref_t<T>> {};
+template <typename T, typename F> struct splits_by_element<Mapped<T, F>> : splits_by_element<remove_cvref_t<T>> {};
+template <typename T, typename F>
+struct splits_by_element<ForwardMapped<T, F>> : splits_by_element<remove_cvref_t<T>> {};
+template <typename T1, typename T2>
+struct splits_by_element<Joined<T1, T2>>
+    : conjunction<splits_by_element<remove_cvref_t<T1>>, splits_by_element<remove_cvref_t<T2>>> {};
+template <typename T1, typename T2>
+struct splits_by_element<ForwardJoined<T1, T2>>
+    : conjunction<splits_by_element<remove_cvref_t<T1>>, splits_by_element<remove_cvref_t<T2>>> {};
+
+// Returns the number of elements in 'collection', walking it only if it does not know its size
+template <typename T> std::size_t CollectionSize(const T& collection, std::true_type /* has_size */) {
+  return collection.size();
+}
+template <typename T> std::size_t CollectionSize(const T& collection, std::false_type /* has_size */) {
+  return static_cast<std::size_t>(std::distance(std::begin(collection), std::end(collection)));
+}
+
+// Returns the number of positions at which 'collection' can be split:
+// asks our own classes, and counts the elements of all other collections.
+template <typename T> std::size_t SplitSize(const T& collection, std::true_type /* has_split_at */) {
+  return collection.split_size();
+}
+template <typename T> std::size_t SplitSize(const T& collection, std::false_type /* has_split_at */) {
+  return CollectionSize(collection, std::integral_constant<bool, has_size<T>::value>{});
+}
+template <typename T> std::size_t SplitSize(const T& collection) {
+  return SplitSize(collection, std::integral_constant<bool, has_split_at<const T>::value>{});
+}
+template <typename T> std::size_t SplitSize(const StoredReference<T>& collection) {
+  return SplitSize(collection.Get());
+}
+
+// Splits 'collection' into a pair of independent halves, where the first one holds the first 'position' positions.
+// Our own classes split themselves, all other collections are split into 2 'Range's over their elements.
+// The halves refer to the elements of 'collection', so it must outlive them.
+template <typename T> auto SplitAt(T& collection, std::size_t position, std::true_type /* has_split_at */) {
+  return collection.split_at(position);
+}
+template <typename T> auto SplitAt(T& collection, std::size_t position, std::false_type /* has_split_at */) {
+  using _iterator = decltype(std::begin(collection));
+  const std::size_t size = SplitSize(collection);
+  const _iterator middle = std::next(std::begin(collection), static_cast<std::ptrdiff_t>(position));
+  return std::make_pair(Range<_iterator>{std::begin(collection), middle, position},
+                        Range<_iterator>{middle, std::end(collection), size - position});
+}
+template <typename T> auto SplitAt(T& collection, std::size_t position) {
+  return SplitAt(collection, position, std::integral_constant<bool, has_split_at<T>::value>{});
+}
+template <typename T> auto SplitAt(StoredReference<T>& collection, std::size_t position) {
+  return SplitAt(collection.Get(), position);
+}
+template <typename T> auto SplitAt(const StoredReference<T>& collection, std::size_t position) {
+  return SplitAt(collection.Get(), position);
+}
+
 }  // namespace details
 
 // Adds chained operators to the derived class,
@@ -382,24 +1177,115 @@ using non_const_reverse_iterator_t =
 // Note that any operator here consumes 'this' by moving it into the returned collection,
 // otherwise doing 'return Iterate(x).Reverse()' would return an instance of Reversed that references an instance of
 // Iterate that is freed the second we exit the function.
-template <typename DerivedClass> class WithChainedOperators {
+//
+// Every iterable class derives from here, which also makes them model 'std::ranges::view' in C++20.
+template <typename DerivedClass> class WithChainedOperators : public details::view_base {
  public:
   template <typename Function> auto map(Function&& function) {
     return Map(MoveSelf(), std::forward<Function>(function));
   }
 
-  template <typename Function> auto filter(Function&& function) {
-    return Filter(MoveSelf(), std::forward<Function>(function));
+  // Takes the function by value (as 'Filter' does): GCC 12 (-O1 and up) miscompiled merging a filter into a Filter
+  // whose function was forwarded by reference, as ipa-modref wrongly found that the result kept nothing it refers to
+  template <typename Function> auto filter(Function function) { return Filter(MoveSelf(), std::move(function)); }
+
+  template <typename Function> auto filter_map(Function&& function) {
+    return FilterMap(MoveSelf(), std::forward<Function>(function));
   }
 
   auto reverse() { return Reverse(MoveSelf()); }
+  auto cache() { return Cache(MoveSelf()); }
+  auto cache_begin() { return CacheBegin(MoveSelf()); }
   auto enumerate() { return Enumerate(MoveSelf()); }
 
+  // Calls 'function(element)' for every element (see 'ForEach')
+  template <typename Function> void for_each(Function function) {
+    ForEach(static_cast<DerivedClass&>(*this), std::move(function));
+  }
+  template <typename Function> void for_each(Function function) const {
+    ForEach(static_cast<const DerivedClass&>(*this), std::move(function));
+  }
+
+  // Calls 'function(block)' for consecutive blocks of elements (see 'ForEachBlock')
+  template <typename Function> void for_each_block(Function function) const {
+    ForEachBlock(static_cast<const DerivedClass&>(*this), std::move(function));
+  }
+
+  // Maps every block of elements with the given kernel (see 'MapBlocks')
+  template <typename Out, typename Kernel> auto map_blocks(Kernel kernel) {
+    return MapBlocks<Out>(MoveSelf(), std::move(kernel));
+  }
+
+  // Runs the terminal operations on all cores (see 'Parallel', which requires including parallel.h)
+  auto parallel() { return Parallel(MoveSelf()); }
+  auto parallel(ThreadPool& pool) { return Parallel(MoveSelf(), pool); }
+
+  // Maps the elements on 'concurrency' threads of their own (see 'MapConcurrent', which requires including parallel.h)
+  template <typename Function> auto map_concurrent(Function function, std::size_t concurrency) {
+    return MapConcurrent(MoveSelf(), std::move(function), concurrency);
+  }
+
+  // Runs everything up to here on a thread of its own (see 'AsyncBuffer', which requires including parallel.h)
+  auto async_buffer(std::size_t capacity) { return AsyncBuffer(MoveSelf(), capacity); }
+
+  // Reduces all the elements to a single value (see 'Sum', 'Min', 'Max', 'MinMax', 'Count' and 'Fold')
+  auto sum() const { return Sum(ConstSelf()); }
+  auto min() const { return Min(ConstSelf()); }
+  auto max() const { return Max(ConstSelf()); }
+  auto minmax() const { return MinMax(ConstSelf()); }
+  std::size_t count() const { return Count(ConstSelf()); }
+  template <typename Value, typename Function> Value fold(Value init, Function function) const {
+    return Fold(ConstSelf(), std::move(init), std::move(function));
+  }
+
+  // Splits the elements into a pair of independent halves of about the same size (see 'split_at').
+  // The halves refer to the elements of this collection, so it must outlive them.
+  auto split() {
+    DerivedClass& self = static_cast<DerivedClass&>(*this);
+    return details::SplitAt(self, details::SplitSize(self) / 2);
+  }
+  auto split() const { return details::SplitAt(ConstSelf(), details::SplitSize(ConstSelf()) / 2); }
+
  private:
   DerivedClass MoveSelf() {
     DerivedClass* self = static_cast<DerivedClass*>(this);
     return std::move(*self);
   }
+  const DerivedClass& ConstSelf() const { return static_cast<const DerivedClass&>(*this); }
+};
+
+// Adds the random-access operators to any iterator class that derives from here,
+// so standard algorithms (like std::lower_bound or std::nth_element) keep their complexity guarantees.
+//
+// The derived class must implement 'Advance(n)' and 'DistanceFrom(other)'.
+// As these operators are only instantiated when used, deriving from here is harmless
+// if the nested iterator does not support random-access.
+template <typename DerivedClass> class WithRandomAccessOperators {
+ public:
+  DerivedClass& operator+=(std::ptrdiff_t n) {
+    Self().Advance(n);
+    return Self();
+  }
+  DerivedClass& operator-=(std::ptrdiff_t n) { return *this += -n; }
+
+  DerivedClass operator+(std::ptrdiff_t n) const {
+    DerivedClass result = Self();
+    result += n;
+    return result;
+  }
+  DerivedClass operator-(std::ptrdiff_t n) const { return *this + -n; }
+  friend DerivedClass operator+(std::ptrdiff_t n, const DerivedClass& iterator) { return iterator + n; }
+
+  std::ptrdiff_t operator-(const DerivedClass& other) const { return Self().DistanceFrom(other); }
+
+  bool operator<(const DerivedClass& other) const { return (*this - other) < 0; }
+  bool operator>(const DerivedClass& other) const { return (*this - other) > 0; }
+  bool operator<=(const DerivedClass& other) const { return !(*this > other); }
+  bool operator>=(const DerivedClass& other) const { return !(*this < other); }
+
+ private:
+  DerivedClass& Self() { return static_cast<DerivedClass&>(*this); }
+  const DerivedClass& Self() const { return static_cast<const DerivedClass&>(*this); }
 };
 
 // Adds operators for 'size/Size' and 'empty/IsEmpty' to any class that derives from here.
@@ -407,13 +1293,10 @@ template <typename DerivedClass> class WithChainedOperators {
 // 'size' is added only if the nested collection supports 'size'
 // (as some STL containers like 'forward_list' do not support it).
 //
-// The derived class must call 'this->InitializeWithSizeAndEmpty' from their constructor.
-template <typename T> class WithSizeAndEmpty {
+// The derived class must store the nested collection in a member called 'iterable_',
+// and must befriend this class.
+template <typename T, typename DerivedClass> class WithSizeAndEmpty {
  public:
-  using _collection_type = typename std::remove_reference<T>::type;
-
-  WithSizeAndEmpty() : data_(nullptr) {}
-
   // STL-container compliant method to check if the container is empty
   bool empty() const { return Data().empty(); }
   // Code style compliant method to check if the container is empty
@@ -428,13 +1311,82 @@ template <typename T> class WithSizeAndEmpty {
     return Data().size();
   }
 
- protected:
-  void InitializeWithSizeAndEmpty(const _collection_type& data) { data_ = &data; }
+ private:
+  // Note: We can not simply store a pointer to the collection, as that pointer would dangle
+  // once the derived class is moved.
+  const auto& Data() const { return static_cast<const DerivedClass&>(*this).iterable_; }
+};
+
+// A block of consecutive values, as handed out by 'ForEachBlock' and to the kernels of 'MapBlocks'
+template <typename T> class Block {
+ public:
+  using value_type = details::remove_cv_t<T>;
+  using iterator = T*;
+
+  Block() : Block(nullptr, 0) {}
+  Block(T* data, std::size_t size) : data_(data), size_(size) {}
+
+  // A block of non-const values can be used as a block of const values
+  template <typename U = T, typename details::enable_if_t<!std::is_const<U>::value, int> = 1>
+  operator Block<const U>() const {
+    return Block<const U>{data_, size_};
+  }
+
+  T* data() const { return data_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  T* begin() const { return data_; }
+  T* end() const { return data_ + size_; }
+  T& operator[](std::size_t index) const { return data_[index]; }
+
+#if defined(__cpp_lib_span)
+  std::span<T> AsSpan() const { return std::span<T>{data_, size_}; }
+#endif
 
  private:
-  const _collection_type& Data() const { return *data_; }
+  T* data_;
+  std::size_t size_;
+};
+
+// A view over the elements in [begin, end) of a collection, as returned when splitting a collection (see 'split_at').
+// Like std::span, a const 'Range' still hands out the iterators it was created with.
+template <typename _iterator> class Range : public WithChainedOperators<Range<_iterator>> {
+ public:
+  using value_type = typename std::iterator_traits<_iterator>::value_type;
+  using iterator = _iterator;
+  using const_iterator = _iterator;
+  using reverse_iterator = std::reverse_iterator<_iterator>;
+  using const_reverse_iterator = reverse_iterator;
+
+  Range(_iterator begin, _iterator end, std::size_t size) : begin_(begin), end_(end), size_(size) {}
+
+  _iterator begin() const { return begin_; }
+  _iterator end() const { return end_; }
+  template <typename X = _iterator,
+            typename details::enable_if_t<details::is_bidirectional_iterator<X>::value, int> = 1>
+  reverse_iterator rbegin() const {
+    return reverse_iterator{end_};
+  }
+  template <typename X = _iterator,
+            typename details::enable_if_t<details::is_bidirectional_iterator<X>::value, int> = 1>
+  reverse_iterator rend() const {
+    return reverse_iterator{begin_};
+  }
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Splits into the first 'position' elements and the remaining ones
+  std::size_t split_size() const { return size_; }
+  std::pair<Range, Range> split_at(std::size_t position) const {
+    const _iterator middle = std::next(begin_, static_cast<std::ptrdiff_t>(position));
+    return std::make_pair(Range{begin_, middle, position}, Range{middle, end_, size_ - position});
+  }
 
-  const _collection_type* data_;
+ private:
+  _iterator begin_;
+  _iterator end_;
+  std::size_t size_;
 };
 
 // Returned value when iterating Enumerate
@@ -453,90 +1405,180 @@ template <typename T> class Item {
   T* value_;
 };
 
-template <typename _iterator, typename _return_type> class EnumeratedIterator {
+// '_knows_end_position' is false if the position of 'end' is unknown, so the iterator can not step back from it
+template <typename _iterator, typename _return_type, bool _knows_end_position = true>
+class EnumeratedIterator
+    : public WithRandomAccessOperators<EnumeratedIterator<_iterator, _return_type, _knows_end_position>> {
  public:
   using _collection_value_type = details::remove_cvref_t<decltype(std::declval<_return_type>().Value())>;
   using _Item = details::remove_cvref_t<_return_type>;
 
-  EnumeratedIterator(_iterator begin, _iterator end, int position, int position_delta)
-      : begin_(begin), end_(end), position_(position), position_delta_(position_delta), item_{} {
-    SetItem();
-  }
+  using iterator_category = details::conditional_t<
+      _knows_end_position, details::iterator_category_t<_iterator>,
+      details::common_iterator_category_t<std::forward_iterator_tag, details::iterator_category_t<_iterator>>>;
+  // Note: 'operator[]' can not return a reference to an item owned by this iterator,
+  // so for the C++20 iterator concepts this is at most a bidirectional iterator.
+  using iterator_concept = details::common_iterator_category_t<std::bidirectional_iterator_tag, iterator_category>;
+  using difference_type = std::ptrdiff_t;
+  using value_type = _Item;
+  using reference = _return_type&;
+  using pointer = _return_type*;
 
-  _return_type& operator*() { return item_; }
+  EnumeratedIterator() : EnumeratedIterator(_iterator{}, 0, 0) {}
+
+  EnumeratedIterator(_iterator begin, int position, int position_delta)
+      : begin_(begin), position_(position), position_delta_(position_delta), item_{} {}
 
   _return_type& operator*() const {
+    // The item is only filled in when dereferencing, so the iterator never needs to know where the collection ends.
+    //
     // Dereferencing a const or a non-const iterator should not make a difference
     // (as the constness of the iterator has no bearing on the returned value of the collection).
     // However, as our iterator owns the return-value struct in this particular case,
     // we must cast the const away to achieve this
-    return const_cast<_return_type&>(item_);
+    _Item& item = const_cast<_Item&>(item_);
+    item = _Item{position_, &NonConstValue()};
+    return item;
   }
 
-  void operator++() {
+  _return_type* operator->() const { return &**this; }
+
+  EnumeratedIterator& operator++() {
     ++begin_;
     position_ += position_delta_;
-    SetItem();
+    return *this;
+  }
+  EnumeratedIterator operator++(int) {
+    EnumeratedIterator result = *this;
+    ++*this;
+    return result;
+  }
+
+  EnumeratedIterator& operator--() {
+    --begin_;
+    position_ -= position_delta_;
+    return *this;
+  }
+  EnumeratedIterator operator--(int) {
+    EnumeratedIterator result = *this;
+    --*this;
+    return result;
   }
 
+  // Returns the item by value, as the item owned by a temporary iterator would not survive this call
+  _Item operator[](std::ptrdiff_t n) const { return *(*this + n); }
+
   bool operator==(const EnumeratedIterator& other) const { return begin_ == other.begin_; }
   bool operator!=(const EnumeratedIterator& other) const { return !(*this == other); }
 
  private:
-  void SetItem() {
-    if (begin_ != end_)
-      item_ = _Item{position_, &NonConstValue()};
+  friend class WithRandomAccessOperators<EnumeratedIterator>;
+
+  void Advance(std::ptrdiff_t n) {
+    begin_ += n;
+    position_ += static_cast<int>(n) * position_delta_;
   }
 
-  _collection_value_type& NonConstValue() { return const_cast<_collection_value_type&>(*begin_); }
+  std::ptrdiff_t DistanceFrom(const EnumeratedIterator& other) const { return begin_ - other.begin_; }
+
+  _collection_value_type& NonConstValue() const { return const_cast<_collection_value_type&>(*begin_); }
 
   _iterator begin_;
-  _iterator end_;
   int position_;
   int position_delta_;
   _Item item_;
 };
 
 // contains the forward iterating shared by all enumerators (forward-only and bidirectional)
-template <typename T> class EnumeratedBase : public WithSizeAndEmpty<T> {
+template <typename T> class EnumeratedBase : public WithSizeAndEmpty<T, EnumeratedBase<T>> {
  public:
   using _collection_type = typename std::remove_reference<T>::type;
   using _collection_value_type = typename _collection_type::value_type;
   using _collection_const_iterator = typename _collection_type::const_iterator;
   using _collection_iterator = typename _collection_type::iterator;
   using _Item = Item<_collection_value_type>;
-  using _non_const_iterator = EnumeratedIterator<_collection_iterator, _Item>;
+  // The position of 'end' is only needed to step back from it. Bidirectional collections must know their size to
+  // compute it without being walked, so enumerating those that do not is forward-only.
+  using _knows_end_position =
+      std::integral_constant<bool, details::is_random_access_iterator<_collection_const_iterator>::value ||
+                                       (details::is_bidirectional_iterator<_collection_const_iterator>::value &&
+                                        details::has_size<T>::value)>;
+  using _non_const_iterator = EnumeratedIterator<_collection_iterator, _Item, _knows_end_position::value>;
 
   using value_type = _Item;
-  using const_iterator = EnumeratedIterator<_collection_const_iterator, const _Item>;
+  using const_iterator = EnumeratedIterator<_collection_const_iterator, const _Item, _knows_end_position::value>;
   using iterator =
       typename details::conditional_t<details::is_const_collection<T>::value, const_iterator, _non_const_iterator>;
 
-  explicit EnumeratedBase(T&& iterable) : iterable_(std::forward<T>(iterable)) {
-    this->InitializeWithSizeAndEmpty(iterable_);
+  // 'first_position' is the position of the first element, which is not 0 for the second half of a split
+  explicit EnumeratedBase(T&& iterable, int first_position = 0)
+      : iterable_(std::forward<T>(iterable)), first_position_(first_position) {}
+
+  const_iterator begin() const { return const_iterator{details::cbegin(iterable_), first_position_, kIncrement}; }
+  const_iterator end() const {
+    return const_iterator{details::cend(iterable_), EndPosition(_knows_end_position{}), kIncrement};
   }
 
-  const_iterator begin() const {
-    return const_iterator{details::cbegin(iterable_), details::cend(iterable_), 0, kIncrement};
+  iterator begin() { return iterator{std::begin(iterable_), first_position_, kIncrement}; }
+  iterator end() { return iterator{std::end(iterable_), EndPosition(_knows_end_position{}), kIncrement}; }
+
+  // Used by 'ForEach'
+  template <typename Sink> void ForEachElement(Sink& sink) {
+    ForEachItem<typename iterator::reference>(iterable_, first_position_, sink);
   }
-  const_iterator end() const {
-    return const_iterator{details::cend(iterable_), details::cend(iterable_), 0, kIncrement};
+  template <typename Sink> void ForEachElement(Sink& sink) const {
+    ForEachItem<typename const_iterator::reference>(iterable_, first_position_, sink);
   }
 
-  iterator begin() { return iterator{std::begin(iterable_), std::end(iterable_), 0, kIncrement}; }
-  iterator end() { return iterator{std::end(iterable_), std::end(iterable_), 0, kIncrement}; }
+  // Splits into 2 halves at the given position of the nested collection (see 'split_at'),
+  // where the items of the second half keep their positions in the whole collection.
+  std::size_t split_size() const { return details::SplitSize(iterable_); }
+  auto split_at(std::size_t position) { return SplitEnumerated(iterable_, first_position_, position); }
+  auto split_at(std::size_t position) const { return SplitEnumerated(iterable_, first_position_, position); }
 
  protected:
+  friend class WithSizeAndEmpty<T, EnumeratedBase>;
+
+  int EndPosition(std::true_type /* knows_end_position */) const {
+    return first_position_ + details::bidirectional_size(iterable_);
+  }
+  int EndPosition(std::false_type /* knows_end_position */) const { return first_position_; }
+
+  template <typename _reference, typename _iterable, typename Sink>
+  static void ForEachItem(_iterable& iterable, int first_position, Sink& sink) {
+    int position = first_position;
+    auto add_position = [&position, &sink](auto& value) {
+      _Item item{position++, &const_cast<_collection_value_type&>(value)};
+      sink(static_cast<_reference>(item));
+    };
+    details::ForEach(iterable, add_position);
+  }
+
+  template <typename _iterable>
+  static auto SplitEnumerated(_iterable& iterable, int first_position, std::size_t position) {
+    auto halves = details::SplitAt(iterable, position);
+    using _half = decltype(halves.first);
+    using _enumerated = details::conditional_t<details::is_bidirectional_collection<_half>::value, Enumerated<_half>,
+                                               ForwardEnumerated<_half>>;
+    // Only count the elements of the first half if its size differs from the position it was split at
+    const int middle_position =
+        first_position + static_cast<int>(details::splits_by_element<_half>::value ? position : Count(halves.first));
+    return std::make_pair(_enumerated{std::move(halves.first), first_position},
+                          _enumerated{std::move(halves.second), middle_position});
+  }
+
   constexpr static int kIncrement = 1;
 
-  T iterable_;
+  details::stored_t<T> iterable_;
+  int first_position_;
 };
 
 // the forward-only enumerator
 template <typename T>
 class ForwardEnumerated : public EnumeratedBase<T>, public WithChainedOperators<ForwardEnumerated<T>> {
  public:
-  explicit ForwardEnumerated(T&& iterable) : EnumeratedBase<T>(std::forward<T>(iterable)) {}
+  explicit ForwardEnumerated(T&& iterable, int first_position = 0)
+      : EnumeratedBase<T>(std::forward<T>(iterable), first_position) {}
 
   // Note: all functionality is proved by the base-classes
 };
@@ -555,35 +1597,29 @@ template <typename T> class Enumerated : public EnumeratedBase<T>, public WithCh
   using reverse_iterator = typename details::conditional_t<details::is_const_collection<T>::value,
                                                            const_reverse_iterator, _non_const_reverse_iterator>;
 
-  explicit Enumerated(T&& iterable) : EnumeratedBase<T>(std::forward<T>(iterable)) {}
+  explicit Enumerated(T&& iterable, int first_position = 0)
+      : EnumeratedBase<T>(std::forward<T>(iterable), first_position) {}
 
   const_reverse_iterator rbegin() const {
-    return const_reverse_iterator{details::crbegin(this->iterable_), details::crend(this->iterable_), MaxPosition(),
-                                  kDecrement};
+    return const_reverse_iterator{details::crbegin(this->iterable_), MaxPosition(), kDecrement};
   }
-
   const_reverse_iterator rend() const {
-    return const_reverse_iterator{details::crend(this->iterable_), details::crend(this->iterable_), MaxPosition(),
-                                  kDecrement};
+    return const_reverse_iterator{details::crend(this->iterable_), RendPosition(), kDecrement};
   }
 
-  reverse_iterator rbegin() {
-    return reverse_iterator{details::rbegin(this->iterable_), details::rend(this->iterable_), MaxPosition(),
-                            kDecrement};
-  }
-
-  reverse_iterator rend() {
-    return reverse_iterator{details::rend(this->iterable_), details::rend(this->iterable_), MaxPosition(), kDecrement};
-  }
+  reverse_iterator rbegin() { return reverse_iterator{details::rbegin(this->iterable_), MaxPosition(), kDecrement}; }
+  reverse_iterator rend() { return reverse_iterator{details::rend(this->iterable_), RendPosition(), kDecrement}; }
 
  private:
-  int MaxPosition() const { return static_cast<int>(this->size()) - 1; }
+  int MaxPosition() const { return this->first_position_ + static_cast<int>(this->size()) - 1; }
+  // 'rend' sits right before the first element
+  int RendPosition() const { return this->first_position_ - 1; }
 
   constexpr static int kDecrement = -1;
 };
 
 // contains the forward iterating shared by all iterators (forward-only and bidirectional)
-template <typename T> class IteratedBase : public WithSizeAndEmpty<T> {
+template <typename T> class IteratedBase : public WithSizeAndEmpty<T, IteratedBase<T>> {
  public:
   using _iterable = typename details::remove_reference_t<T>;
 
@@ -591,17 +1627,66 @@ template <typename T> class IteratedBase : public WithSizeAndEmpty<T> {
   using const_iterator = typename _iterable::const_iterator;
   using iterator = details::non_const_iterator_t<T>;
 
-  explicit IteratedBase(T&& iterable) : iterable_(std::forward<T>(iterable)) {
-    this->InitializeWithSizeAndEmpty(iterable_);
-  }
+  explicit IteratedBase(T&& iterable) : iterable_(std::forward<T>(iterable)) {}
 
   iterator begin() { return std::begin(iterable_); }
   iterator end() { return std::end(iterable_); }
   const_iterator begin() const { return details::cbegin(iterable_); }
   const_iterator end() const { return details::cend(iterable_); }
 
+  // Used by 'ForEach'
+  template <typename Sink> void ForEachElement(Sink& sink) { details::ForEach(iterable_, sink); }
+  template <typename Sink> void ForEachElement(Sink& sink) const { details::ForEach(iterable_, sink); }
+  // Used by 'ForEachBlock'
+  template <typename BlockSink> void ForEachBlockElement(BlockSink& sink) const {
+    details::ForEachBlock(iterable_, sink);
+  }
+
+  // Splits into 2 halves at the given position of the nested collection (see 'split_at')
+  std::size_t split_size() const { return details::SplitSize(iterable_); }
+  auto split_at(std::size_t position) { return SplitIterated(iterable_, position); }
+  auto split_at(std::size_t position) const { return SplitIterated(iterable_, position); }
+
+  // STL-container compliant access to the contiguous storage (if the nested collection is contiguous)
+  template <typename X = T, typename details::enable_if_t<details::is_contiguous_collection<X>::value, int> = 1>
+  auto data() {
+    return iterable_.data();
+  }
+  template <typename X = T, typename details::enable_if_t<details::is_contiguous_collection<X>::value, int> = 1>
+  auto data() const {
+    return details::as_const(iterable_).data();
+  }
+  // Code style compliant access to the contiguous storage (if the nested collection is contiguous)
+  template <typename X = T, typename details::enable_if_t<details::is_contiguous_collection<X>::value, int> = 1>
+  auto Data() {
+    return data();
+  }
+  template <typename X = T, typename details::enable_if_t<details::is_contiguous_collection<X>::value, int> = 1>
+  auto Data() const {
+    return data();
+  }
+
+#if defined(__cpp_lib_span)
+  // Returns a std::span over the contiguous storage (if the nested collection is contiguous)
+  template <typename X = T, typename details::enable_if_t<details::is_contiguous_collection<X>::value, int> = 1>
+  auto AsSpan() {
+    return std::span{data(), iterable_.size()};
+  }
+  template <typename X = T, typename details::enable_if_t<details::is_contiguous_collection<X>::value, int> = 1>
+  auto AsSpan() const {
+    return std::span{data(), iterable_.size()};
+  }
+#endif
+
  protected:
-  T iterable_;
+  friend class WithSizeAndEmpty<T, IteratedBase>;
+
+  template <typename _iterable_type> static auto SplitIterated(_iterable_type& iterable, std::size_t position) {
+    auto halves = details::SplitAt(iterable, position);
+    return std::make_pair(Iterate(std::move(halves.first)), Iterate(std::move(halves.second)));
+  }
+
+  details::stored_t<T> iterable_;
 };
 
 // the forward-only iterator
@@ -627,30 +1712,43 @@ template <typename T> class Iterated : public IteratedBase<T>, public WithChaine
   const_reverse_iterator rend() const { return details::crend(this->iterable_); }
 };
 
-template <typename _outer_iterator, typename _inner_iterator> class ChainedIterator {
+template <typename _outer_iterator, typename _inner_iterator, typename _inner_access = details::forward_access>
+class ChainedIterator {
  public:
-  using _inner_iterator_collection = typename _outer_iterator::value_type;
-  using GetIteratorFunction = _inner_iterator (*)(_inner_iterator_collection&);
-
-  ChainedIterator(_outer_iterator begin, _outer_iterator end, GetIteratorFunction inner_begin_getter,
-                  GetIteratorFunction inner_end_getter)
-      : outer_begin_(begin),
-        outer_end_(end),
-        inner_begin_(),
-        inner_end_(),
-        get_inner_begin_(inner_begin_getter),
-        get_inner_end_(inner_end_getter) {
+  using iterator_category = details::common_iterator_category_t<
+      std::forward_iterator_tag, details::common_iterator_category_t<details::iterator_category_t<_outer_iterator>,
+                                                                     details::iterator_category_t<_inner_iterator>>>;
+  using difference_type = std::ptrdiff_t;
+  using value_type = typename std::iterator_traits<_inner_iterator>::value_type;
+  using reference = typename std::iterator_traits<_inner_iterator>::reference;
+  using pointer = details::arrow_pointer_t<reference>;
+
+  ChainedIterator() : outer_begin_(), outer_end_(), inner_begin_(), inner_end_() {}
+
+  ChainedIterator(_outer_iterator begin, _outer_iterator end)
+      : outer_begin_(begin), outer_end_(end), inner_begin_(), inner_end_() {
     this->InitializeInnerCollection();
     SkipEmptyInnerCollections();
   }
   auto& operator*() const { return *inner_begin_; }
+  pointer operator->() const { return details::arrow_operator<reference>::Apply(**this); }
 
-  void operator++() {
+  ChainedIterator& operator++() {
     ++inner_begin_;
     SkipEmptyInnerCollections();
+    return *this;
+  }
+  ChainedIterator operator++(int) {
+    ChainedIterator result = *this;
+    ++*this;
+    return result;
   }
 
-  bool operator==(const ChainedIterator& other) const { return IsAtEnd() == other.IsAtEnd(); }
+  bool operator==(const ChainedIterator& other) const {
+    if (IsAtEnd() || other.IsAtEnd())
+      return IsAtEnd() == other.IsAtEnd();
+    return outer_begin_ == other.outer_begin_ && inner_begin_ == other.inner_begin_;
+  }
 
   bool operator!=(const ChainedIterator& other) const { return !(*this == other); }
 
@@ -662,8 +1760,8 @@ template <typename _outer_iterator, typename _inner_iterator> class ChainedItera
   // Initialized 'begin' and 'end' for the inner collection
   void InitializeInnerCollection() {
     if (!IsAtEnd()) {
-      inner_begin_ = get_inner_begin_(const_cast<_inner_iterator_collection&>(*outer_begin_));
-      inner_end_ = get_inner_end_(const_cast<_inner_iterator_collection&>(*outer_begin_));
+      inner_begin_ = _inner_access::Begin(*outer_begin_);
+      inner_end_ = _inner_access::End(*outer_begin_);
     }
   }
 
@@ -684,8 +1782,6 @@ template <typename _outer_iterator, typename _inner_iterator> class ChainedItera
   _outer_iterator outer_end_;
   _inner_iterator inner_begin_;
   _inner_iterator inner_end_;
-  GetIteratorFunction get_inner_begin_;
-  GetIteratorFunction get_inner_end_;
 };
 
 // contains the forward iterating shared by all chained iterators (forward-only and bidirectional)
@@ -695,13 +1791,13 @@ template <typename T> class ChainedBase {
   using _outer_const_iterator = typename _outer_collection::const_iterator;
   using _outer_non_const_iterator = typename _outer_collection::iterator;
   using _outer_iterator =
-      details::conditional_t<details::is_const_type<T>::value, _outer_const_iterator, _outer_non_const_iterator>;
+      details::conditional_t<details::is_const_collection<T>::value, _outer_const_iterator, _outer_non_const_iterator>;
 
   using _inner_collection = details::remove_cvref_t<typename _outer_collection::value_type>;
   using _inner_const_iterator = typename _inner_collection::const_iterator;
   using _inner_non_const_iterator = typename _inner_collection::iterator;
   using _inner_iterator =
-      details::conditional_t<details::is_const_type<T>::value, _inner_const_iterator, _inner_non_const_iterator>;
+      details::conditional_t<details::is_const_collection<T>::value, _inner_const_iterator, _inner_non_const_iterator>;
 
   using value_type = typename _inner_collection::value_type;
   using const_iterator = ChainedIterator<_outer_const_iterator, _inner_const_iterator>;
@@ -709,15 +1805,27 @@ template <typename T> class ChainedBase {
 
   ChainedBase(T&& data) : data_(std::forward<T>(data)) {}
 
-  iterator begin() { return iterator{std::begin(data_), std::end(data_), GetBegin, GetEnd}; }
-  iterator end() { return iterator{std::end(data_), std::end(data_), GetBegin, GetEnd}; }
+  iterator begin() { return iterator{std::begin(data_), std::end(data_)}; }
+  iterator end() { return iterator{std::end(data_), std::end(data_)}; }
+  const_iterator begin() const { return const_iterator{details::cbegin(data_), details::cend(data_)}; }
+  const_iterator end() const { return const_iterator{details::cend(data_), details::cend(data_)}; }
 
-  const_iterator begin() const {
-    return const_iterator{details::cbegin(data_), details::cend(data_), GetConstBegin, GetConstEnd};
-  }
-  const_iterator end() const {
-    return const_iterator{details::cend(data_), details::cend(data_), GetConstBegin, GetConstEnd};
+  // Used by 'ForEach': a plain double loop over the outer and the inner collections
+  template <typename Sink> void ForEachElement(Sink& sink) { ForEachInner(data_, sink); }
+  template <typename Sink> void ForEachElement(Sink& sink) const { ForEachInner(data_, sink); }
+  // Used by 'ForEachBlock': hands out the blocks of every inner collection
+  template <typename BlockSink> void ForEachBlockElement(BlockSink& sink) const {
+    auto for_each_inner_block = [&sink](const auto& inner) { details::ForEachBlock(inner, sink); };
+    details::ForEach(data_, for_each_inner_block);
   }
+  // The collection of nested collections, used by 'Parallel' to split the work by nested element
+  auto& Collections() { return data_; }
+  const auto& Collections() const { return data_; }
+
+  // Splits into 2 halves at the given position of the outer collection (see 'split_at')
+  std::size_t split_size() const { return details::SplitSize(data_); }
+  auto split_at(std::size_t position) { return SplitChained(data_, position); }
+  auto split_at(std::size_t position) const { return SplitChained(data_, position); }
 
   // STL-container compliant method to check if the container is empty
   bool empty() const { return IsEmpty(); }
@@ -745,12 +1853,17 @@ template <typename T> class ChainedBase {
   }
 
  protected:
-  static _inner_iterator GetBegin(_inner_collection& collection) { return std::begin(collection); }
-  static _inner_iterator GetEnd(_inner_collection& collection) { return std::end(collection); }
-  static _inner_const_iterator GetConstBegin(_inner_collection& collection) { return details::cbegin(collection); }
-  static _inner_const_iterator GetConstEnd(_inner_collection& collection) { return details::cend(collection); }
+  template <typename _data, typename Sink> static void ForEachInner(_data& data, Sink& sink) {
+    auto for_each_inner = [&sink](auto& inner_collection) { details::ForEach(inner_collection, sink); };
+    details::ForEach(data, for_each_inner);
+  }
+
+  template <typename _data> static auto SplitChained(_data& data, std::size_t position) {
+    auto halves = details::SplitAt(data, position);
+    return std::make_pair(Chain(std::move(halves.first)), Chain(std::move(halves.second)));
+  }
 
-  T data_;
+  details::stored_t<T> data_;
 };
 
 // The forward-only chained iterator
@@ -769,68 +1882,252 @@ template <typename T> class Chained : public ChainedBase<T>, public WithChainedO
   using _outer_const_reverse_iterator = typename _outer_collection::const_reverse_iterator;
   using _outer_non_const_reverse_iterator = typename _outer_collection::reverse_iterator;
   using _outer_reverse_iterator =
-      details::conditional_t<details::is_const_type<T>::value, _outer_const_reverse_iterator,
+      details::conditional_t<details::is_const_collection<T>::value, _outer_const_reverse_iterator,
                              _outer_non_const_reverse_iterator>;
 
   using _inner_const_reverse_iterator = typename _inner_collection::const_reverse_iterator;
   using _inner_non_const_reverse_iterator = typename _inner_collection::reverse_iterator;
   using _inner_reverse_iterator =
-      details::conditional_t<details::is_const_type<T>::value, _inner_const_reverse_iterator,
+      details::conditional_t<details::is_const_collection<T>::value, _inner_const_reverse_iterator,
                              _inner_non_const_reverse_iterator>;
 
-  using const_reverse_iterator = ChainedIterator<_outer_const_reverse_iterator, _inner_const_reverse_iterator>;
-  using reverse_iterator = ChainedIterator<_outer_reverse_iterator, _inner_reverse_iterator>;
+  using const_reverse_iterator =
+      ChainedIterator<_outer_const_reverse_iterator, _inner_const_reverse_iterator, details::reverse_access>;
+  using reverse_iterator = ChainedIterator<_outer_reverse_iterator, _inner_reverse_iterator, details::reverse_access>;
 
   Chained(T&& data) : ChainedBase<T>(std::forward<T>(data)) {}
 
-  reverse_iterator rbegin() {
-    return reverse_iterator{details::rbegin(this->data_), details::rend(this->data_), GetReverseBegin, GetReverseEnd};
+  reverse_iterator rbegin() { return reverse_iterator{details::rbegin(this->data_), details::rend(this->data_)}; }
+  reverse_iterator rend() { return reverse_iterator{details::rend(this->data_), details::rend(this->data_)}; }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator{details::crbegin(this->data_), details::crend(this->data_)};
+  }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator{details::crend(this->data_), details::crend(this->data_)};
   }
+};
 
-  reverse_iterator rend() {
-    return reverse_iterator{details::rend(this->data_), details::rend(this->data_), GetReverseBegin, GetReverseEnd};
+// Walks the elements of an 'IndexedChained', where 'offsets' holds the position of the first element of every
+// nested collection, followed by the total number of elements
+template <typename _outer_iterator, typename _inner_iterator>
+class IndexedChainedIterator
+    : public WithRandomAccessOperators<IndexedChainedIterator<_outer_iterator, _inner_iterator>> {
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using difference_type = std::ptrdiff_t;
+  using value_type = typename std::iterator_traits<_inner_iterator>::value_type;
+  using reference = typename std::iterator_traits<_inner_iterator>::reference;
+  using pointer = details::arrow_pointer_t<reference>;
+
+  IndexedChainedIterator() : collections_(), offsets_(nullptr), count_(0), outer_(0), position_(0), inner_() {}
+
+  // 'count' is the number of nested collections (so 'offsets' holds 'count + 1' positions)
+  IndexedChainedIterator(_outer_iterator collections, const std::size_t* offsets, std::size_t count,
+                         std::size_t position)
+      : collections_(collections), offsets_(offsets), count_(count), outer_(0), position_(position), inner_() {
+    Seek();
+  }
+
+  reference operator*() const { return *inner_; }
+  pointer operator->() const { return details::arrow_operator<reference>::Apply(**this); }
+  reference operator[](std::ptrdiff_t n) const { return *(*this + n); }
+
+  IndexedChainedIterator& operator++() {
+    ++inner_;
+    ++position_;
+    if (position_ == offsets_[outer_ + 1])
+      SkipEmptyInnerCollections();
+    return *this;
+  }
+  IndexedChainedIterator operator++(int) {
+    IndexedChainedIterator result = *this;
+    ++*this;
+    return result;
   }
 
-  const_reverse_iterator rbegin() const {
-    return const_reverse_iterator{details::crbegin(this->data_), details::crend(this->data_), GetConstReverseBegin,
-                                  GetConstReverseEnd};
+  // Note: Just like for any other iterator, you can not decrement the iterator pointing to the first element.
+  IndexedChainedIterator& operator--() {
+    --position_;
+    if (position_ + 1 == offsets_[outer_])
+      Seek();
+    else
+      --inner_;
+    return *this;
+  }
+  IndexedChainedIterator operator--(int) {
+    IndexedChainedIterator result = *this;
+    --*this;
+    return result;
   }
 
-  const_reverse_iterator rend() const {
-    return const_reverse_iterator{details::crend(this->data_), details::crend(this->data_), GetConstReverseBegin,
-                                  GetConstReverseEnd};
+  bool operator==(const IndexedChainedIterator& other) const { return position_ == other.position_; }
+  bool operator!=(const IndexedChainedIterator& other) const { return !(*this == other); }
+
+ private:
+  friend class WithRandomAccessOperators<IndexedChainedIterator>;
+
+  void Advance(std::ptrdiff_t n) {
+    position_ = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(position_) + n);
+    Seek();
+  }
+  std::ptrdiff_t DistanceFrom(const IndexedChainedIterator& other) const {
+    return static_cast<std::ptrdiff_t>(position_) - static_cast<std::ptrdiff_t>(other.position_);
+  }
+
+  // Finds the nested collection holding 'position_' (the last one that starts at or before it)
+  void Seek() {
+    outer_ = static_cast<std::size_t>(std::upper_bound(offsets_, offsets_ + count_ + 1, position_) - offsets_) - 1;
+    InitializeInnerCollection();
+  }
+
+  // Moves on to the next non-empty collection, once the current one is exhausted
+  void SkipEmptyInnerCollections() {
+    do {
+      ++outer_;
+    } while (outer_ < count_ && offsets_[outer_ + 1] == position_);
+    InitializeInnerCollection();
+  }
+
+  void InitializeInnerCollection() {
+    if (outer_ < count_) {
+      inner_ = std::begin(collections_[static_cast<std::ptrdiff_t>(outer_)]) +
+               static_cast<std::ptrdiff_t>(position_ - offsets_[outer_]);
+    }
+  }
+
+  _outer_iterator collections_;
+  // Points into the index of the chain, which (unlike the chain itself) stays in place when the chain is moved
+  const std::size_t* offsets_;
+  std::size_t count_;
+  std::size_t outer_;
+  std::size_t position_;
+  _inner_iterator inner_;
+};
+
+template <typename T> class IndexedChained : public WithChainedOperators<IndexedChained<T>> {
+ public:
+  using _outer_collection = details::remove_cvref_t<T>;
+  using _outer_const_iterator = typename _outer_collection::const_iterator;
+  using _outer_non_const_iterator = typename _outer_collection::iterator;
+  using _outer_iterator =
+      details::conditional_t<details::is_const_collection<T>::value, _outer_const_iterator, _outer_non_const_iterator>;
+
+  using _inner_collection = details::remove_cvref_t<typename _outer_collection::value_type>;
+  using _inner_const_iterator = typename _inner_collection::const_iterator;
+  using _inner_non_const_iterator = typename _inner_collection::iterator;
+  using _inner_iterator =
+      details::conditional_t<details::is_const_collection<T>::value, _inner_const_iterator, _inner_non_const_iterator>;
+
+  static_assert(details::is_random_access_iterator<_outer_const_iterator>::value &&
+                    details::is_random_access_iterator<_inner_const_iterator>::value,
+                "IndexedChain needs a random-access collection of random-access collections (see Chain)");
+
+  using value_type = typename _inner_collection::value_type;
+  using const_iterator = IndexedChainedIterator<_outer_const_iterator, _inner_const_iterator>;
+  using iterator = IndexedChainedIterator<_outer_iterator, _inner_iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+
+  explicit IndexedChained(T&& data) : data_(std::forward<T>(data)), offsets_{0} {
+    for (const auto& collection : data_)
+      offsets_.push_back(offsets_.back() + static_cast<std::size_t>(details::cend(collection) -
+                                                                    details::cbegin(collection)));
+  }
+
+  iterator begin() { return At(std::begin(data_), 0); }
+  iterator end() { return At(std::begin(data_), Size()); }
+  const_iterator begin() const { return At(details::cbegin(data_), 0); }
+  const_iterator end() const { return At(details::cbegin(data_), Size()); }
+  reverse_iterator rbegin() { return reverse_iterator{end()}; }
+  reverse_iterator rend() { return reverse_iterator{begin()}; }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator{end()}; }
+  const_reverse_iterator rend() const { return const_reverse_iterator{begin()}; }
+
+  typename iterator::reference operator[](std::size_t position) { return *At(std::begin(data_), position); }
+  typename const_iterator::reference operator[](std::size_t position) const {
+    return *At(details::cbegin(data_), position);
   }
 
+  // Used by 'ForEach': a plain double loop over the outer and the inner collections
+  template <typename Sink> void ForEachElement(Sink& sink) { ForEachInner(data_, sink); }
+  template <typename Sink> void ForEachElement(Sink& sink) const { ForEachInner(data_, sink); }
+
+  // STL-container compliant method to get the size
+  std::size_t size() const { return Size(); }
+  // Code style compliant method to get the size
+  std::size_t Size() const { return offsets_.back(); }
+  // STL-container compliant method to check if the container is empty
+  bool empty() const { return IsEmpty(); }
+  // Code style compliant method to check if the container is empty
+  bool IsEmpty() const { return Size() == 0; }
+
  private:
-  static _inner_reverse_iterator GetReverseBegin(_inner_collection& collection) { return details::rbegin(collection); }
-  static _inner_reverse_iterator GetReverseEnd(_inner_collection& collection) { return details::rend(collection); }
-  static _inner_const_reverse_iterator GetConstReverseBegin(_inner_collection& collection) {
-    return details::crbegin(collection);
+  template <typename _iterator> IndexedChainedIterator<_iterator, decltype(std::begin(*std::declval<_iterator>()))>
+  At(_iterator collections, std::size_t position) const {
+    return {collections, offsets_.data(), offsets_.size() - 1, position};
   }
 
-  static _inner_const_reverse_iterator GetConstReverseEnd(_inner_collection& collection) {
-    return details::crend(collection);
+  template <typename _data, typename Sink> static void ForEachInner(_data& data, Sink& sink) {
+    auto for_each_inner = [&sink](auto& inner_collection) { details::ForEach(inner_collection, sink); };
+    details::ForEach(data, for_each_inner);
   }
+
+  details::stored_t<T> data_;
+  // The position of the first element of every nested collection, followed by the total number of elements
+  std::vector<std::size_t> offsets_;
 };
 
-template <typename _iterator, typename _return_value> class ReferencedIterator {
+template <typename _iterator, typename _return_value>
+class ReferencedIterator : public WithRandomAccessOperators<ReferencedIterator<_iterator, _return_value>> {
  public:
-  ReferencedIterator(_iterator begin, _iterator end) : begin_(begin), end_(end) {}
+  using iterator_category = details::iterator_category_t<_iterator>;
+  using difference_type = std::ptrdiff_t;
+  using value_type = details::remove_cv_t<_return_value>;
+  using reference = _return_value&;
+  using pointer = _return_value*;
+
+  ReferencedIterator() : begin_() {}
+  explicit ReferencedIterator(_iterator begin) : begin_(begin) {}
 
   _return_value& operator*() const { return **begin_; }
+  _return_value& operator[](std::ptrdiff_t n) const { return *begin_[n]; }
+
+  _return_value* operator->() const { return &**this; }
+
+  ReferencedIterator& operator++() {
+    ++begin_;
+    return *this;
+  }
+  ReferencedIterator operator++(int) {
+    ReferencedIterator result = *this;
+    ++*this;
+    return result;
+  }
 
-  void operator++() { ++begin_; }
+  ReferencedIterator& operator--() {
+    --begin_;
+    return *this;
+  }
+  ReferencedIterator operator--(int) {
+    ReferencedIterator result = *this;
+    --*this;
+    return result;
+  }
 
   bool operator==(const ReferencedIterator& other) const { return begin_ == other.begin_; }
   bool operator!=(const ReferencedIterator& other) const { return !(*this == other); }
 
  private:
+  friend class WithRandomAccessOperators<ReferencedIterator>;
+
+  void Advance(std::ptrdiff_t n) { begin_ += n; }
+  std::ptrdiff_t DistanceFrom(const ReferencedIterator& other) const { return begin_ - other.begin_; }
+
   _iterator begin_;
-  _iterator end_;
 };
 
 // contains the forward iterating shared by all referenced iterators (forward-only and bidirectional)
-template <typename T> class ReferencedBase : public WithSizeAndEmpty<T> {
+template <typename T> class ReferencedBase : public WithSizeAndEmpty<T, ReferencedBase<T>> {
  public:
   using _collection_type = typename details::remove_reference_t<T>;
   using _collection_value_type = details::remove_pointer_t<typename _collection_type::value_type>;
@@ -843,17 +2140,31 @@ template <typename T> class ReferencedBase : public WithSizeAndEmpty<T> {
   using iterator =
       typename details::conditional_t<details::is_const_type<T>::value, const_iterator, _non_const_iterator>;
 
-  explicit ReferencedBase(T&& iterable) : iterable_(std::forward<T>(iterable)) {
-    this->InitializeWithSizeAndEmpty(iterable_);
-  }
+  explicit ReferencedBase(T&& iterable) : iterable_(std::forward<T>(iterable)) {}
+
+  iterator begin() { return iterator{std::begin(iterable_)}; }
+  iterator end() { return iterator{std::end(iterable_)}; }
+  const_iterator begin() const { return const_iterator{details::cbegin(iterable_)}; }
+  const_iterator end() const { return const_iterator{details::cend(iterable_)}; }
 
-  iterator begin() { return iterator{std::begin(iterable_), std::end(iterable_)}; }
-  iterator end() { return iterator{std::end(iterable_), std::end(iterable_)}; }
-  const_iterator begin() const { return const_iterator{details::cbegin(iterable_), details::cend(iterable_)}; }
-  const_iterator end() const { return const_iterator{details::cend(iterable_), details::cend(iterable_)}; }
+  // Used by 'ForEach'
+  template <typename Sink> void ForEachElement(Sink& sink) {
+    ForEachReferenced<typename iterator::reference>(iterable_, sink);
+  }
+  template <typename Sink> void ForEachElement(Sink& sink) const {
+    ForEachReferenced<typename const_iterator::reference>(iterable_, sink);
+  }
 
  protected:
-  T iterable_;
+  friend class WithSizeAndEmpty<T, ReferencedBase>;
+
+  template <typename _reference, typename _iterable, typename Sink>
+  static void ForEachReferenced(_iterable& iterable, Sink& sink) {
+    auto dereference = [&sink](const auto& pointer) { sink(static_cast<_reference>(*pointer)); };
+    details::ForEach(iterable, dereference);
+  }
+
+  details::stored_t<T> iterable_;
 };
 
 // the forward-only referenced iterator
@@ -878,19 +2189,10 @@ template <typename T> class Referenced : public ReferencedBase<T>, public WithCh
                                                            _non_const_reverse_iterator>;
   explicit Referenced(T&& iterable) : ReferencedBase<T>(std::forward<T>(iterable)) {}
 
-  reverse_iterator rbegin() {
-    return reverse_iterator{details::rbegin(this->iterable_), details::rend(this->iterable_)};
-  }
-
-  reverse_iterator rend() { return reverse_iterator{details::rend(this->iterable_), details::rend(this->iterable_)}; }
-
-  const_reverse_iterator rbegin() const {
-    return const_reverse_iterator{details::crbegin(this->iterable_), details::crend(this->iterable_)};
-  }
-
-  const_reverse_iterator rend() const {
-    return const_reverse_iterator{details::crend(this->iterable_), details::crend(this->iterable_)};
-  }
+  reverse_iterator rbegin() { return reverse_iterator{details::rbegin(this->iterable_)}; }
+  reverse_iterator rend() { return reverse_iterator{details::rend(this->iterable_)}; }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator{details::crbegin(this->iterable_)}; }
+  const_reverse_iterator rend() const { return const_reverse_iterator{details::crend(this->iterable_)}; }
 };
 
 template <typename T, typename details::enable_if_t<!details::is_unique_pointer_collection<T>::value, int>>
@@ -898,28 +2200,61 @@ auto AsReferences(T&& iterable) -> Referenced<T> {
   return Referenced<T>{std::forward<T>(iterable)};
 }
 
-template <typename _iterator, typename _return_value> class ReferencedUniqueIterator {
+template <typename _iterator, typename _return_value>
+class ReferencedUniqueIterator : public WithRandomAccessOperators<ReferencedUniqueIterator<_iterator, _return_value>> {
  public:
-  ReferencedUniqueIterator(_iterator begin, _iterator end) : begin_(begin), end_(end) {}
+  using iterator_category = details::iterator_category_t<_iterator>;
+  using difference_type = std::ptrdiff_t;
+  using value_type = details::remove_cv_t<_return_value>;
+  using reference = _return_value&;
+  using pointer = _return_value*;
+
+  ReferencedUniqueIterator() : begin_() {}
+  explicit ReferencedUniqueIterator(_iterator begin) : begin_(begin) {}
 
   _return_value& operator*() const {
     auto& unique_pointer = *begin_;
     auto* pointer = unique_pointer.get();
     return *pointer;
   }
+  _return_value& operator[](std::ptrdiff_t n) const { return *begin_[n]; }
+
+  _return_value* operator->() const { return &**this; }
+
+  ReferencedUniqueIterator& operator++() {
+    ++begin_;
+    return *this;
+  }
+  ReferencedUniqueIterator operator++(int) {
+    ReferencedUniqueIterator result = *this;
+    ++*this;
+    return result;
+  }
 
-  void operator++() { ++begin_; }
+  ReferencedUniqueIterator& operator--() {
+    --begin_;
+    return *this;
+  }
+  ReferencedUniqueIterator operator--(int) {
+    ReferencedUniqueIterator result = *this;
+    --*this;
+    return result;
+  }
 
   bool operator==(const ReferencedUniqueIterator& other) const { return begin_ == other.begin_; }
   bool operator!=(const ReferencedUniqueIterator& other) const { return !(*this == other); }
 
  private:
+  friend class WithRandomAccessOperators<ReferencedUniqueIterator>;
+
+  void Advance(std::ptrdiff_t n) { begin_ += n; }
+  std::ptrdiff_t DistanceFrom(const ReferencedUniqueIterator& other) const { return begin_ - other.begin_; }
+
   _iterator begin_;
-  _iterator end_;
 };
 
 // contains the forward iterating shared by all referenced iterators (forward-only and bidirectional)
-template <typename T> class ReferencedUniqueBase : public WithSizeAndEmpty<T> {
+template <typename T> class ReferencedUniqueBase : public WithSizeAndEmpty<T, ReferencedUniqueBase<T>> {
  public:
   using _collection_type = typename details::remove_reference_t<T>;
   using _collection_value_type = typename _collection_type::value_type;
@@ -932,17 +2267,31 @@ template <typename T> class ReferencedUniqueBase : public WithSizeAndEmpty<T> {
   using iterator =
       typename details::conditional_t<details::is_const_type<T>::value, const_iterator, _non_const_iterator>;
 
-  explicit ReferencedUniqueBase(T&& iterable) : iterable_(std::forward<T>(iterable)) {
-    this->InitializeWithSizeAndEmpty(iterable_);
-  }
+  explicit ReferencedUniqueBase(T&& iterable) : iterable_(std::forward<T>(iterable)) {}
+
+  iterator begin() { return iterator{std::begin(iterable_)}; }
+  iterator end() { return iterator{std::end(iterable_)}; }
+  const_iterator begin() const { return const_iterator{details::cbegin(iterable_)}; }
+  const_iterator end() const { return const_iterator{details::cend(iterable_)}; }
 
-  iterator begin() { return iterator{std::begin(iterable_), std::end(iterable_)}; }
-  iterator end() { return iterator{std::end(iterable_), std::end(iterable_)}; }
-  const_iterator begin() const { return const_iterator{details::cbegin(iterable_), details::cend(iterable_)}; }
-  const_iterator end() const { return const_iterator{details::cend(iterable_), details::cend(iterable_)}; }
+  // Used by 'ForEach'
+  template <typename Sink> void ForEachElement(Sink& sink) {
+    ForEachReferenced<typename iterator::reference>(iterable_, sink);
+  }
+  template <typename Sink> void ForEachElement(Sink& sink) const {
+    ForEachReferenced<typename const_iterator::reference>(iterable_, sink);
+  }
 
  protected:
-  T iterable_;
+  friend class WithSizeAndEmpty<T, ReferencedUniqueBase>;
+
+  template <typename _reference, typename _iterable, typename Sink>
+  static void ForEachReferenced(_iterable& iterable, Sink& sink) {
+    auto dereference = [&sink](const auto& unique_pointer) { sink(static_cast<_reference>(*unique_pointer.get())); };
+    details::ForEach(iterable, dereference);
+  }
+
+  details::stored_t<T> iterable_;
 };
 
 // The forward-only referenced iterator
@@ -970,22 +2319,14 @@ class ReferencedUnique : public ReferencedUniqueBase<T>, public WithChainedOpera
 
   explicit ReferencedUnique(T&& iterable) : ReferencedUniqueBase<T>(std::forward<T>(iterable)) {}
 
-  reverse_iterator rbegin() {
-    return reverse_iterator{details::rbegin(this->iterable_), details::rend(this->iterable_)};
-  }
-
-  reverse_iterator rend() { return reverse_iterator{details::rend(this->iterable_), details::rend(this->iterable_)}; }
-
-  const_reverse_iterator rbegin() const {
-    return const_reverse_iterator{details::crbegin(this->iterable_), details::crend(this->iterable_)};
-  }
-
-  const_reverse_iterator rend() const {
-    return const_reverse_iterator{details::crend(this->iterable_), details::crend(this->iterable_)};
-  }
+  reverse_iterator rbegin() { return reverse_iterator{details::rbegin(this->iterable_)}; }
+  reverse_iterator rend() { return reverse_iterator{details::rend(this->iterable_)}; }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator{details::crbegin(this->iterable_)}; }
+  const_reverse_iterator rend() const { return const_reverse_iterator{details::crend(this->iterable_)}; }
 };
 
-template <typename T> class Reversed : public WithChainedOperators<Reversed<T>>, public WithSizeAndEmpty<T> {
+template <typename T>
+class Reversed : public WithChainedOperators<Reversed<T>>, public WithSizeAndEmpty<T, Reversed<T>> {
  public:
   using _iterable = typename details::remove_reference_t<T>;
 
@@ -995,9 +2336,7 @@ template <typename T> class Reversed : public WithChainedOperators<Reversed<T>>,
   using const_reverse_iterator = typename _iterable::const_iterator;
   using reverse_iterator = details::non_const_iterator_t<T>;
 
-  explicit Reversed(T&& iterable) : iterable_(std::forward<T>(iterable)) {
-    this->InitializeWithSizeAndEmpty(iterable_);
-  }
+  explicit Reversed(T&& iterable) : iterable_(std::forward<T>(iterable)) {}
 
   iterator begin() { return details::rbegin(iterable_); }
   iterator end() { return details::rend(iterable_); }
@@ -1008,13 +2347,27 @@ template <typename T> class Reversed : public WithChainedOperators<Reversed<T>>,
   const_reverse_iterator rbegin() const { return details::cbegin(iterable_); }
   const_reverse_iterator rend() const { return details::cend(iterable_); }
 
+  // Used by 'Reverse' to cancel out 2 consecutive reverses
+  auto Unreverse() && { return Iterate(details::release_stored<T>(iterable_)); }
+
  private:
-  T iterable_;
+  friend class WithSizeAndEmpty<T, Reversed>;
+
+  details::stored_t<T> iterable_;
 };
 
 // The iterator used by 'Join'
 template <typename _FirstIterator, typename _SecondIterator> class JoinedIterator {
  public:
+  using iterator_category = details::common_iterator_category_t<
+      std::forward_iterator_tag, details::common_iterator_category_t<details::iterator_category_t<_FirstIterator>,
+                                                                     details::iterator_category_t<_SecondIterator>>>;
+  using difference_type = std::ptrdiff_t;
+  using value_type = typename std::iterator_traits<_FirstIterator>::value_type;
+  using reference = decltype(*std::declval<_FirstIterator>());
+  using pointer = details::arrow_pointer_t<reference>;
+
+  JoinedIterator() : first_(), first_end_(), second_(), second_end_() {}
   JoinedIterator(_FirstIterator first, _FirstIterator first_end, _SecondIterator second, _SecondIterator second_end)
       : first_(first), first_end_(first_end), second_(second), second_end_(second_end) {}
   auto& operator*() const {
@@ -1022,12 +2375,19 @@ template <typename _FirstIterator, typename _SecondIterator> class JoinedIterato
       return *first_;
     return *second_;
   }
+  pointer operator->() const { return details::arrow_operator<reference>::Apply(**this); }
 
-  void operator++() {
+  JoinedIterator& operator++() {
     if (first_ != first_end_)
       ++first_;
     else
       ++second_;
+    return *this;
+  }
+  JoinedIterator operator++(int) {
+    JoinedIterator result = *this;
+    ++*this;
+    return result;
   }
 
   bool operator==(const JoinedIterator& other) const { return first_ == other.first_ && second_ == other.second_; }
@@ -1074,6 +2434,22 @@ template <typename T1, typename T2> class JoinedBase {
     return const_iterator{details::cend(first_), details::cend(first_), details::cend(second_), details::cend(second_)};
   }
 
+  // Used by 'ForEach': simply walks both collections back-to-back
+  template <typename Sink> void ForEachElement(Sink& sink) {
+    auto& self = details::const_if<details::is_any_const<T1, T2>::value>::Apply(*this);
+    details::ForEach(self.first_, sink);
+    details::ForEach(self.second_, sink);
+  }
+  template <typename Sink> void ForEachElement(Sink& sink) const {
+    details::ForEach(first_, sink);
+    details::ForEach(second_, sink);
+  }
+  // Used by 'ForEachBlock'
+  template <typename BlockSink> void ForEachBlockElement(BlockSink& sink) const {
+    details::ForEachBlock(first_, sink);
+    details::ForEachBlock(second_, sink);
+  }
+
   // STL-container compliant method to check if the container is empty
   bool empty() const { return first_.empty() && second_.empty(); }
   // Code style compliant method to check if the container is empty
@@ -1088,9 +2464,24 @@ template <typename T1, typename T2> class JoinedBase {
     return first_.size() + second_.size();
   }
 
+  // Splits into 2 halves at the given position (see 'split_at'),
+  // where the positions of the second collection follow those of the first one.
+  std::size_t split_size() const { return details::SplitSize(first_) + details::SplitSize(second_); }
+  auto split_at(std::size_t position) { return SplitJoined(first_, second_, position); }
+  auto split_at(std::size_t position) const { return SplitJoined(first_, second_, position); }
+
  protected:
-  T1 first_;
-  T2 second_;
+  template <typename _first, typename _second>
+  static auto SplitJoined(_first& first, _second& second, std::size_t position) {
+    const std::size_t first_position = std::min(position, details::SplitSize(first));
+    auto first_halves = details::SplitAt(first, first_position);
+    auto second_halves = details::SplitAt(second, position - first_position);
+    return std::make_pair(Join(std::move(first_halves.first), std::move(second_halves.first)),
+                          Join(std::move(first_halves.second), std::move(second_halves.second)));
+  }
+
+  details::stored_t<T1> first_;
+  details::stored_t<T2> second_;
 };
 
 // The forward-only joined iterator
@@ -1143,58 +2534,129 @@ class Joined : public JoinedBase<T1, T2>, public WithChainedOperators<Joined<T1,
 };
 
 // the iterator used by 'Map'
-template <typename _iterable, typename _function> class MappedIterator {
+template <typename _iterable, typename _function>
+class MappedIterator : public WithRandomAccessOperators<MappedIterator<_iterable, _function>> {
  public:
-  MappedIterator(_iterable begin, _iterable end, const _function& mapping_function)
-      : begin_(begin), end_(end), mapping_function_(mapping_function) {}
-
-  auto operator*() const { return mapping_function_(*begin_); }
+  using iterator_category = details::iterator_category_t<_iterable>;
+  using difference_type = std::ptrdiff_t;
+  // Exactly what the mapping-function returns, so returning a reference (e.g. to a member) does not copy
+  using reference = decltype(std::declval<const _function&>()(*std::declval<_iterable>()));
+  using value_type = details::remove_cvref_t<reference>;
+  using pointer = details::arrow_pointer_t<reference>;
+
+  MappedIterator() : begin_(), mapping_function_(nullptr) {}
+  MappedIterator(_iterable begin, const _function& mapping_function)
+      : begin_(begin), mapping_function_(&mapping_function) {}
+
+  reference operator*() const { return (*mapping_function_)(*begin_); }
+  reference operator[](std::ptrdiff_t n) const { return (*mapping_function_)(begin_[n]); }
+  pointer operator->() const { return details::arrow_operator<reference>::Apply(**this); }
+
+  MappedIterator& operator++() {
+    ++begin_;
+    return *this;
+  }
+  MappedIterator operator++(int) {
+    MappedIterator result = *this;
+    ++*this;
+    return result;
+  }
 
-  void operator++() { ++begin_; }
+  MappedIterator& operator--() {
+    --begin_;
+    return *this;
+  }
+  MappedIterator operator--(int) {
+    MappedIterator result = *this;
+    --*this;
+    return result;
+  }
 
   bool operator==(const MappedIterator& other) const { return begin_ == other.begin_; }
   bool operator!=(const MappedIterator& other) const { return !(*this == other); }
 
  private:
+  friend class WithRandomAccessOperators<MappedIterator>;
+
+  void Advance(std::ptrdiff_t n) { begin_ += n; }
+  std::ptrdiff_t DistanceFrom(const MappedIterator& other) const { return begin_ - other.begin_; }
+
   _iterable begin_;
-  _iterable end_;
-  const _function& mapping_function_;
+  // Stored as a pointer (and not as a reference) so the iterator can be assigned to
+  const _function* mapping_function_;
 };
 
 // contains the forward iterating shared by all mapped iterators (forward-only and bidirectional)
-template <typename T, typename Function> class MappedBase : public WithSizeAndEmpty<T> {
+template <typename T, typename Function>
+class MappedBase : public WithSizeAndEmpty<T, MappedBase<T, Function>> {
  public:
   using _iterable = typename details::remove_reference_t<T>;
   using _iterable_value_type = typename _iterable::value_type;
   using _iterable_const_iterator = typename _iterable::const_iterator;
   using _iterable_iterator = typename _iterable::iterator;
-  using _non_const_iterator = MappedIterator<_iterable_iterator, typename details::remove_reference_t<Function>>;
+  using _function = details::assignable_function_t<Function>;
+  using _non_const_iterator = MappedIterator<_iterable_iterator, _function>;
 
-  using value_type = typename std::result_of<Function(_iterable_value_type&)>::type;
-  using const_iterator = MappedIterator<_iterable_const_iterator, typename details::remove_reference_t<Function>>;
+  using value_type = details::remove_cvref_t<typename std::result_of<Function(_iterable_value_type&)>::type>;
+  using const_iterator = MappedIterator<_iterable_const_iterator, _function>;
   using iterator =
       typename details::conditional_t<details::is_const_type<T>::value, const_iterator, _non_const_iterator>;
 
   MappedBase(T&& iterable, Function&& mapping_function)
-      : iterable_(std::forward<T>(iterable)), mapping_function_(std::forward<Function>(mapping_function)) {
-    this->InitializeWithSizeAndEmpty(iterable_);
-  }
+      : iterable_(std::forward<T>(iterable)), mapping_function_(std::forward<Function>(mapping_function)) {}
+
+  iterator begin() { return iterator{std::begin(iterable_), mapping_function_}; }
+  iterator end() { return iterator{std::end(iterable_), mapping_function_}; }
+  const_iterator begin() const { return const_iterator{details::cbegin(iterable_), mapping_function_}; }
+  const_iterator end() const { return const_iterator{details::cend(iterable_), mapping_function_}; }
+
+  // Used by 'ForEach'
+  template <typename Sink> void ForEachElement(Sink& sink) { ForEachMapped(iterable_, mapping_function_, sink); }
+  template <typename Sink> void ForEachElement(Sink& sink) const { ForEachMapped(iterable_, mapping_function_, sink); }
+  // Used by 'ForEachBlock': maps a whole block at once
+  template <typename BlockSink> void ForEachBlockElement(BlockSink& sink) const {
+    using _input = details::block_value_t<details::stored_t<T>>;
+    using _output = details::remove_cvref_t<decltype(mapping_function_(std::declval<const _input&>()))>;
+    std::vector<_output> output(kBlockSize);
+    auto map_block = [this, &output, &sink](Block<const _input> input) {
+      Block<_output> mapped{output.data(), input.size()};
+      details::MapBlock(mapping_function_, input, mapped, details::is_block_kernel<_function>{});
+      sink(Block<const _output>{mapped});
+    };
+    details::ForEachBlock(iterable_, map_block);
+  }
+
+  // Used by 'Map' to fuse 2 consecutive mapping-functions
+  template <typename NextFunction> auto ThenMap(NextFunction next_function) && {
+    using _composed_function = details::ComposedFunction<_function, NextFunction>;
+    return Map(details::release_stored<T>(iterable_),
+               _composed_function{std::move(mapping_function_), std::move(next_function)});
+  }
+
+  // Splits into 2 halves at the given position of the nested collection (see 'split_at'),
+  // which both get a copy of the mapping-function.
+  std::size_t split_size() const { return details::SplitSize(iterable_); }
+  auto split_at(std::size_t position) { return SplitMapped(iterable_, mapping_function_, position); }
+  auto split_at(std::size_t position) const { return SplitMapped(iterable_, mapping_function_, position); }
 
-  iterator begin() { return iterator{std::begin(iterable_), std::end(iterable_), mapping_function_}; }
-
-  iterator end() { return iterator{std::end(iterable_), std::end(iterable_), mapping_function_}; }
+ protected:
+  friend class WithSizeAndEmpty<T, MappedBase>;
 
-  const_iterator begin() const {
-    return const_iterator{details::cbegin(iterable_), details::cend(iterable_), mapping_function_};
+  template <typename _iterable_type>
+  static auto SplitMapped(_iterable_type& iterable, const _function& mapping_function, std::size_t position) {
+    auto halves = details::SplitAt(iterable, position);
+    return std::make_pair(Map(std::move(halves.first), mapping_function),
+                          Map(std::move(halves.second), mapping_function));
   }
 
-  const_iterator end() const {
-    return const_iterator{details::cend(iterable_), details::cend(iterable_), mapping_function_};
+  template <typename _iterable_type, typename Sink>
+  static void ForEachMapped(_iterable_type& iterable, const _function& mapping_function, Sink& sink) {
+    auto map = [&mapping_function, &sink](auto&& value) { sink(mapping_function(value)); };
+    details::ForEach(iterable, map);
   }
 
- protected:
-  T iterable_;
-  Function mapping_function_;
+  details::stored_t<T> iterable_;
+  _function mapping_function_;
 };
 
 // The forward-only mapped iterator
@@ -1211,70 +2673,107 @@ template <typename T, typename Function>
 class Mapped : public MappedBase<T, Function>, public WithChainedOperators<Mapped<T, Function>> {
  public:
   using typename MappedBase<T, Function>::_iterable;
+  using typename MappedBase<T, Function>::_function;
   using _iterable_const_reverse_iterator = typename _iterable::const_reverse_iterator;
   using _iterable_reverse_iterator = typename _iterable::reverse_iterator;
-  using _non_const_reverse_iterator =
-      MappedIterator<_iterable_reverse_iterator, typename details::remove_reference_t<Function>>;
+  using _non_const_reverse_iterator = MappedIterator<_iterable_reverse_iterator, _function>;
 
-  using const_reverse_iterator =
-      MappedIterator<_iterable_const_reverse_iterator, typename details::remove_reference_t<Function>>;
+  using const_reverse_iterator = MappedIterator<_iterable_const_reverse_iterator, _function>;
   using reverse_iterator = typename details::conditional_t<details::is_const_type<T>::value, const_reverse_iterator,
                                                            _non_const_reverse_iterator>;
 
   Mapped(T&& iterable, Function&& mapping_function)
       : MappedBase<T, Function>(std::forward<T>(iterable), std::forward<Function>(mapping_function)) {}
 
-  reverse_iterator rbegin() {
-    return reverse_iterator{details::rbegin(this->iterable_), details::rend(this->iterable_), this->mapping_function_};
-  }
-
-  reverse_iterator rend() {
-    return reverse_iterator{details::rend(this->iterable_), details::rend(this->iterable_), this->mapping_function_};
-  }
-
+  reverse_iterator rbegin() { return reverse_iterator{details::rbegin(this->iterable_), this->mapping_function_}; }
+  reverse_iterator rend() { return reverse_iterator{details::rend(this->iterable_), this->mapping_function_}; }
   const_reverse_iterator rbegin() const {
-    return const_reverse_iterator{details::crbegin(this->iterable_), details::crend(this->iterable_),
-                                  this->mapping_function_};
+    return const_reverse_iterator{details::crbegin(this->iterable_), this->mapping_function_};
   }
-
   const_reverse_iterator rend() const {
-    return const_reverse_iterator{details::crend(this->iterable_), details::crend(this->iterable_),
-                                  this->mapping_function_};
+    return const_reverse_iterator{details::crend(this->iterable_), this->mapping_function_};
   }
 };
 
 // The iterator used by 'Filter'
-template <typename _iterable, typename _function> class FilterIterator {
+//
+// Rather than storing its own copy of 'end' and of the filter, the iterator points to the 'Filtered' class that owns
+// both, which keeps it small even when nesting many operators.
+// Elements that are returned by value (e.g. by a mapping-function) are only computed once: the filter and
+// 'operator*' both use the copy the iterator keeps of the current element (as its base class, so iterators
+// that do not need one don't get any bigger).
+template <typename _iterable, typename _owner, typename _access>
+class FilterIterator : private details::filter_cache_t<decltype(*std::declval<const _iterable&>())> {
  public:
-  using _return_type = typename std::result_of<decltype (&_iterable::operator*)(_iterable)>::type;
+  using _return_type = decltype(*std::declval<const _iterable&>());
 
-  FilterIterator(_iterable begin, _iterable end, const _function& filter) : begin_(begin), end_(end), filter_(filter) {
-    SkipFilteredEntries();
-  }
+  using iterator_category =
+      details::common_iterator_category_t<std::bidirectional_iterator_tag, details::iterator_category_t<_iterable>>;
+  using difference_type = std::ptrdiff_t;
+  using value_type = details::remove_cvref_t<_return_type>;
+  using reference = _return_type;
+  using pointer = details::arrow_pointer_t<reference>;
+
+  using _cache = details::filter_cache_t<_return_type>;
+  using _caches_value = std::integral_constant<bool, !std::is_same<_cache, details::no_cache>::value>;
 
-  _return_type operator*() const { return *begin_; }
+  FilterIterator() : begin_(), owner_(nullptr) {}
+  FilterIterator(_iterable begin, _owner& owner) : begin_(begin), owner_(&owner) { SkipFilteredEntries(); }
 
-  void operator++() {
+  _return_type operator*() const { return Dereference(_caches_value{}); }
+  pointer operator->() const { return details::arrow_operator<reference>::Apply(**this); }
+
+  FilterIterator& operator++() {
     ++begin_;
     SkipFilteredEntries();
+    return *this;
+  }
+  FilterIterator operator++(int) {
+    FilterIterator result = *this;
+    ++*this;
+    return result;
+  }
+
+  // Note: Just like for any other iterator, you can not decrement the iterator pointing to the first element.
+  FilterIterator& operator--() {
+    do {
+      --begin_;
+    } while (IsFiltered());
+    return *this;
+  }
+  FilterIterator operator--(int) {
+    FilterIterator result = *this;
+    --*this;
+    return result;
   }
 
   bool operator==(const FilterIterator& other) const { return begin_ == other.begin_; }
   bool operator!=(const FilterIterator& other) const { return !(*this == other); }
 
  private:
-  bool IsEnd() const { return begin_ == end_; }
+  bool IsEnd() const { return begin_ == _access::End(owner_->iterable_); }
+
+  bool IsFiltered() { return IsFiltered(_caches_value{}); }
+  bool IsFiltered(std::true_type /* caches_value */) {
+    Current().Emplace(*begin_);
+    return !owner_->filter_(static_cast<const value_type&>(Current().Get()));
+  }
+  bool IsFiltered(std::false_type /* caches_value */) const { return !owner_->filter_(*begin_); }
 
-  bool IsFiltered() const { return !filter_(*begin_); }
+  _return_type Dereference(std::true_type /* caches_value */) const { return Current().Get(); }
+  _return_type Dereference(std::false_type /* caches_value */) const { return *begin_; }
 
   void SkipFilteredEntries() {
     while (!IsEnd() && IsFiltered())
       ++begin_;
   }
 
+  _cache& Current() { return *this; }
+  const _cache& Current() const { return *this; }
+
   _iterable begin_;
-  _iterable end_;
-  const _function& filter_;
+  // Stored as a pointer (and not as a reference) so the iterator can be assigned to
+  _owner* owner_;
 };
 
 // contains the forward iterating shared by all filtered iterators (forward-only and bidirectional)
@@ -1283,20 +2782,57 @@ template <typename T, typename FilterFunction> class FilteredBase {
   using _iterable = typename details::remove_reference_t<T>;
   using _iterable_const_iterator = typename _iterable::const_iterator;
   using _iterable_iterator = typename _iterable::iterator;
-  using _non_const_iterator = FilterIterator<_iterable_iterator, typename details::remove_reference_t<FilterFunction>>;
+  using _function = details::assignable_function_t<FilterFunction>;
+  using _non_const_iterator = FilterIterator<_iterable_iterator, FilteredBase, details::forward_access>;
 
   using value_type = typename _iterable::value_type;
-  using const_iterator = FilterIterator<_iterable_const_iterator, typename details::remove_reference_t<FilterFunction>>;
+  using const_iterator = FilterIterator<_iterable_const_iterator, const FilteredBase, details::forward_access>;
   using iterator =
-      typename details::conditional_t<details::is_const_type<T>::value, const_iterator, _non_const_iterator>;
+      typename details::conditional_t<details::is_const_collection<T>::value, const_iterator, _non_const_iterator>;
 
   FilteredBase(T&& iterable, FilterFunction&& filter)
       : iterable_(std::forward<T>(iterable)), filter_(std::forward<FilterFunction>(filter)) {}
 
-  iterator begin() { return iterator{std::begin(iterable_), std::end(iterable_), filter_}; }
-  iterator end() { return iterator{std::end(iterable_), std::end(iterable_), filter_}; }
-  const_iterator begin() const { return const_iterator{details::cbegin(iterable_), details::cend(iterable_), filter_}; }
-  const_iterator end() const { return const_iterator{details::cend(iterable_), details::cend(iterable_), filter_}; }
+  iterator begin() { return iterator{std::begin(iterable_), *this}; }
+  iterator end() { return iterator{std::end(iterable_), *this}; }
+  const_iterator begin() const { return const_iterator{details::cbegin(iterable_), *this}; }
+  const_iterator end() const { return const_iterator{details::cend(iterable_), *this}; }
+
+  // Used by 'ForEach'
+  template <typename Sink> void ForEachElement(Sink& sink) { ForEachFiltered(iterable_, filter_, sink); }
+  template <typename Sink> void ForEachElement(Sink& sink) const { ForEachFiltered(iterable_, filter_, sink); }
+  // Used by 'ForEachBlock': first selects the values to keep without branching, then copies them
+  template <typename BlockSink> void ForEachBlockElement(BlockSink& sink) const {
+    using _value = details::block_value_t<details::stored_t<T>>;
+    std::vector<std::uint16_t> selection(kBlockSize);
+    std::vector<_value> output(kBlockSize);
+    auto filter_block = [this, &selection, &output, &sink](Block<const _value> input) {
+      const std::size_t count = details::SelectBlock(filter_, input, selection.data());
+      for (std::size_t i = 0; i < count; i++)
+        output[i] = input[selection[i]];
+      if (count != 0)
+        sink(Block<const _value>{output.data(), count});
+    };
+    details::ForEachBlock(iterable_, filter_block);
+  }
+
+  // Used by 'Filter' to merge 2 consecutive filters
+  template <typename NextFilter> auto ThenFilter(NextFilter next_filter) && {
+    using _conjunction_function = details::ConjunctionFunction<_function, NextFilter>;
+    return Filter(details::release_stored<T>(iterable_),
+                  _conjunction_function{std::move(filter_), std::move(next_filter)});
+  }
+
+  // Splits into 2 halves at the given position of the nested collection (see 'split_at'),
+  // which both get a copy of the filter.
+  // Note: as the filter is only checked while iterating, the halves need not hold the same number of elements.
+  std::size_t split_size() const { return details::SplitSize(iterable_); }
+  auto split_at(std::size_t position) { return SplitFiltered(iterable_, filter_, position); }
+  auto split_at(std::size_t position) const { return SplitFiltered(iterable_, filter_, position); }
+
+  // The nested collection and the filter, used by 'Parallel' to compact the selected elements in parallel
+  const auto& Collection() const { return iterable_; }
+  const _function& Predicate() const { return filter_; }
 
   // STL-container compliant method to check if the container is empty
   bool empty() const { return IsEmpty(); }
@@ -1321,8 +2857,25 @@ template <typename T, typename FilterFunction> class FilteredBase {
   }
 
  protected:
-  T iterable_;
-  FilterFunction filter_;
+  template <typename, typename, typename> friend class FilterIterator;
+
+  template <typename _iterable_type, typename Sink>
+  static void ForEachFiltered(_iterable_type& iterable, const _function& filter, Sink& sink) {
+    auto filter_values = [&filter, &sink](auto&& value) {
+      if (filter(value))
+        sink(std::forward<decltype(value)>(value));
+    };
+    details::ForEach(iterable, filter_values);
+  }
+
+  template <typename _iterable_type>
+  static auto SplitFiltered(_iterable_type& iterable, const _function& filter, std::size_t position) {
+    auto halves = details::SplitAt(iterable, position);
+    return std::make_pair(Filter(std::move(halves.first), filter), Filter(std::move(halves.second), filter));
+  }
+
+  details::stored_t<T> iterable_;
+  _function filter_;
 };
 
 // The forward-only filtered iterator
@@ -1340,34 +2893,225 @@ template <typename T, typename FilterFunction>
 class Filtered : public FilteredBase<T, FilterFunction>, public WithChainedOperators<Filtered<T, FilterFunction>> {
  public:
   using typename FilteredBase<T, FilterFunction>::_iterable;
+  using typename FilteredBase<T, FilterFunction>::_function;
+  using _base = FilteredBase<T, FilterFunction>;
   using _iterable_const_reverse_iterator = typename _iterable::const_reverse_iterator;
   using _iterable_reverse_iterator = typename _iterable::reverse_iterator;
-  using _non_const_reverse_iterator =
-      FilterIterator<_iterable_reverse_iterator, typename details::remove_reference_t<FilterFunction>>;
+  using _non_const_reverse_iterator = FilterIterator<_iterable_reverse_iterator, _base, details::reverse_access>;
 
   using const_reverse_iterator =
-      FilterIterator<_iterable_const_reverse_iterator, typename details::remove_reference_t<FilterFunction>>;
+      FilterIterator<_iterable_const_reverse_iterator, const _base, details::reverse_access>;
   using reverse_iterator = typename details::conditional_t<details::is_const_type<T>::value, const_reverse_iterator,
                                                            _non_const_reverse_iterator>;
 
   Filtered(T&& iterable, FilterFunction&& filter)
       : FilteredBase<T, FilterFunction>(std::forward<T>(iterable), std::forward<FilterFunction>(filter)) {}
 
-  reverse_iterator rbegin() {
-    return reverse_iterator{details::rbegin(this->iterable_), details::rend(this->iterable_), this->filter_};
+  reverse_iterator rbegin() { return reverse_iterator{details::rbegin(this->iterable_), *this}; }
+  reverse_iterator rend() { return reverse_iterator{details::rend(this->iterable_), *this}; }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator{details::crbegin(this->iterable_), *this}; }
+  const_reverse_iterator rend() const { return const_reverse_iterator{details::crend(this->iterable_), *this}; }
+};
+
+namespace details {
+
+// The elements of the collection of 'Cached', which it computes as they are needed
+template <typename T> class ElementCache {
+ public:
+  using _iterable = remove_reference_t<T>;
+  using _iterable_const_iterator = typename _iterable::const_iterator;
+
+  using value_type = remove_cvref_t<decltype(*std::declval<const _iterable_const_iterator&>())>;
+
+  explicit ElementCache(T&& iterable) : iterable_(std::forward<T>(iterable)) {}
+
+  // True if the collection has an element at 'position', which is then cached
+  bool Has(std::size_t position) {
+    if (!started_) {
+      next_ = details::cbegin(iterable_);
+      started_ = true;
+    }
+    for (; values_.size() <= position && next_ != details::cend(iterable_); ++next_)
+      values_.push_back(*next_);
+    return position < values_.size();
+  }
+  const value_type& Get(std::size_t position) {
+    Has(position);
+    return values_[position];
+  }
+  std::size_t Size() {
+    Has(std::numeric_limits<std::size_t>::max());
+    return values_.size();
   }
 
-  reverse_iterator rend() {
-    return reverse_iterator{details::rend(this->iterable_), details::rend(this->iterable_), this->filter_};
+ private:
+  stored_t<T> iterable_;
+  // std::deque never moves its elements when it grows
+  std::deque<value_type> values_{};
+  // The next element of the collection to cache
+  _iterable_const_iterator next_{};
+  bool started_ = false;
+};
+
+// The iterator used by 'Cache', which refers to the elements by their position
+template <typename _cache> class CachedIterator {
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using difference_type = std::ptrdiff_t;
+  using value_type = typename _cache::value_type;
+  using reference = const value_type&;
+  using pointer = const value_type*;
+
+  // The position of 'end', as the size is only known once all the elements are cached
+  static constexpr std::size_t kEnd = std::numeric_limits<std::size_t>::max();
+
+  CachedIterator() = default;
+  CachedIterator(_cache* cache, std::size_t position) : cache_(cache), position_(position) {}
+
+  reference operator*() const { return cache_->Get(position_); }
+  pointer operator->() const { return std::addressof(**this); }
+
+  CachedIterator& operator++() {
+    ++position_;
+    return *this;
+  }
+  CachedIterator operator++(int) {
+    CachedIterator result = *this;
+    ++*this;
+    return result;
   }
 
-  const_reverse_iterator rbegin() const {
-    return const_reverse_iterator{details::crbegin(this->iterable_), details::crend(this->iterable_), this->filter_};
+  CachedIterator& operator--() {
+    if (position_ == kEnd)
+      position_ = cache_->Size();
+    --position_;
+    return *this;
+  }
+  CachedIterator operator--(int) {
+    CachedIterator result = *this;
+    --*this;
+    return result;
   }
 
-  const_reverse_iterator rend() const {
-    return const_reverse_iterator{details::crend(this->iterable_), details::crend(this->iterable_), this->filter_};
+  bool operator==(const CachedIterator& other) const {
+    if (position_ == kEnd || other.position_ == kEnd)
+      return AtEnd() == other.AtEnd();
+    return position_ == other.position_;
+  }
+  bool operator!=(const CachedIterator& other) const { return !(*this == other); }
+
+ private:
+  bool AtEnd() const { return position_ == kEnd || !cache_->Has(position_); }
+
+  _cache* cache_ = nullptr;
+  std::size_t position_ = kEnd;
+};
+
+}  // namespace details
+
+// Returned by 'Cache'.
+// The elements are stored outside of this class, so moving it does not invalidate its iterators.
+template <typename T> class Cached : public WithChainedOperators<Cached<T>> {
+ public:
+  using _cache = details::ElementCache<T>;
+
+  using value_type = typename _cache::value_type;
+  using const_iterator = details::CachedIterator<_cache>;
+  using iterator = const_iterator;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using reverse_iterator = const_reverse_iterator;
+
+  explicit Cached(T&& iterable) : cache_(std::make_shared<_cache>(std::forward<T>(iterable))) {}
+
+  const_iterator begin() const { return const_iterator{cache_.get(), 0}; }
+  const_iterator end() const { return const_iterator{cache_.get(), const_iterator::kEnd}; }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator{end()}; }
+  const_reverse_iterator rend() const { return const_reverse_iterator{begin()}; }
+
+  // STL-container compliant method to check if the container is empty
+  bool empty() const { return !cache_->Has(0); }
+  // Code style compliant method to check if the container is empty
+  bool IsEmpty() const { return empty(); }
+  // STL-container compliant method to get the size (which computes all the elements)
+  std::size_t size() const { return cache_->Size(); }
+  // Code style compliant method to get the size (which computes all the elements)
+  std::size_t Size() const { return size(); }
+
+ private:
+  std::shared_ptr<_cache> cache_;
+};
+
+// Remembers the begin and the size of a collection once they are computed (see 'CacheBegin')
+template <typename T> class BeginCached : public WithChainedOperators<BeginCached<T>> {
+ public:
+  using _iterable = details::remove_cvref_t<T>;
+
+  using value_type = typename _iterable::value_type;
+  using const_iterator = typename _iterable::const_iterator;
+  using iterator = const_iterator;
+
+  static_assert(details::is_forward_iterator<const_iterator>::value,
+                "The begin of a collection that can only be iterated once can not be remembered");
+
+  explicit BeginCached(T&& iterable) : iterable_(std::forward<T>(iterable)) {}
+  // Copies find the begin again, as the remembered one may point into the original
+  BeginCached(const BeginCached& other) : iterable_(other.iterable_) {}
+  BeginCached(BeginCached&& other) : iterable_(std::move(other.iterable_)) {}
+  BeginCached& operator=(const BeginCached& other) {
+    iterable_ = other.iterable_;
+    Forget();
+    return *this;
+  }
+  BeginCached& operator=(BeginCached&& other) {
+    iterable_ = std::move(other.iterable_);
+    Forget();
+    return *this;
+  }
+
+  const_iterator begin() const {
+    if (!has_begin_) {
+      begin_.Emplace(details::cbegin(iterable_));
+      has_begin_ = true;
+    }
+    return begin_.Get();
+  }
+  const_iterator end() const { return details::cend(iterable_); }
+
+  // Used by 'ForEach': the nested collection drives its own loop
+  template <typename Sink> void ForEachElement(Sink& sink) const { details::ForEach(iterable_, sink); }
+
+  // STL-container compliant method to check if the container is empty
+  bool empty() const { return begin() == end(); }
+  // Code style compliant method to check if the container is empty
+  bool IsEmpty() const { return empty(); }
+  // STL-container compliant method to get the size (which is asked or counted once)
+  std::size_t size() const {
+    if (size_ == kUnknownSize)
+      size_ = CountSize(std::integral_constant<bool, details::has_size<T>::value>{});
+    return size_;
+  }
+  // Code style compliant method to get the size (which is asked or counted once)
+  std::size_t Size() const { return size(); }
+
+ private:
+  static constexpr std::size_t kUnknownSize = std::numeric_limits<std::size_t>::max();
+
+  // The nested collection may know its size without walking its elements (like 'Chain')
+  std::size_t CountSize(std::true_type /* has_size */) const { return iterable_.size(); }
+  std::size_t CountSize(std::false_type /* has_size */) const {
+    return static_cast<std::size_t>(std::distance(begin(), end()));
   }
+
+  void Forget() {
+    begin_.Reset();
+    has_begin_ = false;
+    size_ = kUnknownSize;
+  }
+
+  details::stored_t<T> iterable_;
+  mutable details::CachedValue<const_iterator> begin_;
+  mutable bool has_begin_ = false;
+  mutable std::size_t size_ = kUnknownSize;
 };
 
 // Returned value when iterating Zip
@@ -1388,49 +3132,101 @@ template <typename T1, typename T2> class ZippedValue {
 };
 
 // The iterator used by 'Zip'
-template <typename _first_iterator, typename _second_iterator, typename _return_type> class ZippedIterator {
+template <typename _first_iterator, typename _second_iterator, typename _return_type>
+class ZippedIterator
+    : public WithRandomAccessOperators<ZippedIterator<_first_iterator, _second_iterator, _return_type>> {
  public:
   using _first_value_type = details::remove_cvref_t<decltype(std::declval<_return_type>().First())>;
   using _second_value_type = details::remove_cvref_t<decltype(std::declval<_return_type>().Second())>;
   using _ZippedValue = details::remove_cvref_t<_return_type>;
 
+  using iterator_category = details::common_iterator_category_t<details::iterator_category_t<_first_iterator>,
+                                                                details::iterator_category_t<_second_iterator>>;
+  // Note: 'operator[]' can not return a reference to a value owned by this iterator,
+  // so for the C++20 iterator concepts this is at most a bidirectional iterator.
+  using iterator_concept = details::common_iterator_category_t<std::bidirectional_iterator_tag, iterator_category>;
+  using difference_type = std::ptrdiff_t;
+  using value_type = _ZippedValue;
+  using reference = _return_type&;
+  using pointer = _return_type*;
+
+  ZippedIterator() : ZippedIterator(_first_iterator{}, _first_iterator{}, _second_iterator{}, _second_iterator{}) {}
+
   ZippedIterator(_first_iterator first_begin, _first_iterator first_end, _second_iterator second_begin,
                  _second_iterator second_end)
       : first_begin_(first_begin),
         first_end_(first_end),
         second_begin_(second_begin),
         second_end_(second_end),
-        value_{} {
-    SetValue();
-  }
-
-  _return_type& operator*() { return value_; }
+        value_{} {}
 
   _return_type& operator*() const {
+    // The value is only filled in when dereferencing, so walking the collections does not touch the elements.
+    //
     // Dereferencing a const or a non-const iterator should not make a difference
     // (as the constness of the iterator has no bearing on the returned value of the collection).
-    return const_cast<_return_type&>(value_);
+    _ZippedValue& value = const_cast<_ZippedValue&>(value_);
+    value = _ZippedValue{&NonConstFirstValue(), &NonConstSecondValue()};
+    return value;
   }
 
-  void operator++() {
+  _return_type* operator->() const { return &**this; }
+
+  ZippedIterator& operator++() {
     ++first_begin_;
     ++second_begin_;
-    SetValue();
+    return *this;
+  }
+  ZippedIterator operator++(int) {
+    ZippedIterator result = *this;
+    ++*this;
+    return result;
+  }
+
+  ZippedIterator& operator--() {
+    --first_begin_;
+    --second_begin_;
+    return *this;
+  }
+  ZippedIterator operator--(int) {
+    ZippedIterator result = *this;
+    --*this;
+    return result;
   }
 
-  bool operator==(const ZippedIterator& other) const { return IsAtEnd() == other.IsAtEnd(); }
+  // Returns the value by value, as the value owned by a temporary iterator would not survive this call
+  _ZippedValue operator[](std::ptrdiff_t n) const { return *(*this + n); }
+
+  bool operator==(const ZippedIterator& other) const {
+    // All iterators where either collection is exhausted are equal to 'end'
+    if (IsAtEnd() || other.IsAtEnd())
+      return IsAtEnd() == other.IsAtEnd();
+    return first_begin_ == other.first_begin_;
+  }
   bool operator!=(const ZippedIterator& other) const { return !(*this == other); }
 
  private:
-  bool IsAtEnd() const { return (first_begin_ == first_end_ || second_begin_ == second_end_); }
+  friend class WithRandomAccessOperators<ZippedIterator>;
+
+  void Advance(std::ptrdiff_t n) {
+    first_begin_ += n;
+    second_begin_ += n;
+  }
 
-  void SetValue() {
-    if (!IsAtEnd())
-      value_ = _ZippedValue{&NonConstFirstValue(), &NonConstSecondValue()};
+  std::ptrdiff_t DistanceFrom(const ZippedIterator& other) const {
+    // 'end' is positioned at the end of both collections, but iteration stops at the end of the shortest one.
+    // So we return the distance to whichever end is reached first.
+    std::ptrdiff_t first_distance = first_begin_ - other.first_begin_;
+    std::ptrdiff_t second_distance = second_begin_ - other.second_begin_;
+    if (first_distance >= 0 && second_distance >= 0)
+      return std::min(first_distance, second_distance);
+    return std::max(first_distance, second_distance);
   }
 
-  _first_value_type& NonConstFirstValue() { return const_cast<_first_value_type&>(*first_begin_); }
-  _second_value_type& NonConstSecondValue() { return const_cast<_second_value_type&>(*second_begin_); }
+  bool IsAtEnd() const { return (first_begin_ == first_end_ || second_begin_ == second_end_); }
+
+  _first_value_type& NonConstFirstValue() const { return const_cast<_first_value_type&>(*first_begin_); }
+  _second_value_type& NonConstSecondValue() const { return const_cast<_second_value_type&>(*second_begin_); }
 
   _first_iterator first_begin_;
   _first_iterator first_end_;
@@ -1473,6 +3269,16 @@ template <typename T1, typename T2> class ZippedBase {
   iterator begin() { return iterator{std::begin(first_), std::end(first_), std::begin(second_), std::end(second_)}; }
   iterator end() { return iterator{std::end(first_), std::end(first_), std::end(second_), std::end(second_)}; }
 
+  // Used by 'ForEach'
+  template <typename Sink> void ForEachElement(Sink& sink) {
+    ForEachPair<typename iterator::reference>(std::begin(first_), std::end(first_), std::begin(second_),
+                                              std::end(second_), sink);
+  }
+  template <typename Sink> void ForEachElement(Sink& sink) const {
+    ForEachPair<typename const_iterator::reference>(details::cbegin(first_), details::cend(first_),
+                                                    details::cbegin(second_), details::cend(second_), sink);
+  }
+
   // STL-container compliant method to check if the container is empty
   bool empty() const { return first_.empty() || second_.empty(); }
   // Code style compliant method to check if the container is empty
@@ -1487,9 +3293,35 @@ template <typename T1, typename T2> class ZippedBase {
     return std::min(first_.size(), second_.size());
   }
 
+  // Splits both collections at the same position (see 'split_at'), so the halves keep the pairs aligned
+  std::size_t split_size() const { return std::min(details::SplitSize(first_), details::SplitSize(second_)); }
+  auto split_at(std::size_t position) { return SplitZipped(first_, second_, position); }
+  auto split_at(std::size_t position) const { return SplitZipped(first_, second_, position); }
+
  protected:
-  T1 first_;
-  T2 second_;
+  template <typename _first, typename _second>
+  static auto SplitZipped(_first& first, _second& second, std::size_t position) {
+    static_assert(details::splits_by_element<details::remove_cvref_t<T1>>::value &&
+                      details::splits_by_element<details::remove_cvref_t<T2>>::value,
+                  "Zip can only be split if both collections are split by element (so not over Filter or Chain)");
+    auto first_halves = details::SplitAt(first, position);
+    auto second_halves = details::SplitAt(second, position);
+    return std::make_pair(Zip(std::move(first_halves.first), std::move(second_halves.first)),
+                          Zip(std::move(first_halves.second), std::move(second_halves.second)));
+  }
+
+  template <typename _reference, typename _first_iterator, typename _second_iterator, typename Sink>
+  static void ForEachPair(_first_iterator first, _first_iterator first_end, _second_iterator second,
+                          _second_iterator second_end, Sink& sink) {
+    for (; first != first_end && second != second_end; ++first, ++second) {
+      _Value value{&const_cast<_first_collection_value_type&>(*first),
+                   &const_cast<_second_collection_value_type&>(*second)};
+      sink(static_cast<_reference>(value));
+    }
+  }
+
+  details::stored_t<T1> first_;
+  details::stored_t<T2> second_;
 };
 
 // the forward-only version
@@ -1545,6 +3377,373 @@ class Zipped : public ZippedBase<T1, T2>, public WithChainedOperators<Zipped<T1,
                             details::rend(this->second_)};
   }
 };
+
+//-----------------------------------------------------------------------------
+// Terminal operations
+//-----------------------------------------------------------------------------
+
+namespace details {
+
+#if defined(__cpp_lib_has_unique_object_representations)
+template <typename T> using has_unique_representation = std::has_unique_object_representations<T>;
+#else
+template <typename T>
+using has_unique_representation =
+    std::integral_constant<bool, std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value>;
+#endif
+
+template <typename T> using contiguous_value_t = remove_cvref_t<decltype(*std::declval<const T&>().data())>;
+
+// True if the elements of 'T' can be copied to 'OutputIterator' with memcpy
+template <typename T, typename OutputIterator, bool = is_contiguous_collection<T>::value>
+struct can_copy_bytes : std::false_type {};
+template <typename T, typename OutputIterator>
+struct can_copy_bytes<T, OutputIterator, true>
+    : conjunction<std::is_trivially_copyable<contiguous_value_t<T>>,
+                  std::is_same<OutputIterator, contiguous_value_t<T>*>> {};
+
+// True if the elements of 'T1' and 'T2' can be compared with memcmp
+template <typename T1, typename T2,
+          bool = conjunction<is_contiguous_collection<T1>, is_contiguous_collection<T2>>::value>
+struct can_compare_bytes : std::false_type {};
+template <typename T1, typename T2>
+struct can_compare_bytes<T1, T2, true>
+    : conjunction<std::is_same<contiguous_value_t<T1>, contiguous_value_t<T2>>,
+                  has_unique_representation<contiguous_value_t<T1>>> {};
+
+// True if the elements of 'T' can be hashed from their contiguous bytes
+template <typename T, bool = is_contiguous_collection<T>::value> struct can_hash_bytes : std::false_type {};
+template <typename T> struct can_hash_bytes<T, true> : has_unique_representation<contiguous_value_t<T>> {};
+
+template <typename T, typename OutputIterator>
+OutputIterator CopyElements(const T& iterable, OutputIterator output, std::true_type /* can_copy_bytes */) {
+  const std::size_t size = iterable.size();
+  if (size != 0)
+    std::memcpy(output, iterable.data(), size * sizeof(*output));
+  return output + size;
+}
+template <typename T, typename OutputIterator>
+OutputIterator CopyElements(const T& iterable, OutputIterator output, std::false_type /* can_copy_bytes */) {
+  for (const auto& value : iterable)
+    *output++ = value;
+  return output;
+}
+
+template <typename T1, typename T2>
+bool EqualElements(const T1& iterable_1, const T2& iterable_2, std::true_type /* can_compare_bytes */) {
+  const std::size_t size = iterable_1.size();
+  if (size != iterable_2.size())
+    return false;
+  return size == 0 || std::memcmp(iterable_1.data(), iterable_2.data(), size * sizeof(*iterable_1.data())) == 0;
+}
+template <typename T1, typename T2>
+bool EqualElements(const T1& iterable_1, const T2& iterable_2, std::false_type /* can_compare_bytes */) {
+  auto first = std::begin(iterable_1);
+  auto first_end = std::end(iterable_1);
+  auto second = std::begin(iterable_2);
+  auto second_end = std::end(iterable_2);
+  for (; first != first_end && second != second_end; ++first, ++second) {
+    if (!(*first == *second))
+      return false;
+  }
+  return first == first_end && second == second_end;
+}
+
+// Streaming hash that consumes its input 8 bytes at a time.
+// Feeding the same bytes gives the same result, regardless of how they are split over the calls to Update().
+class ByteHasher {
+ public:
+  void Update(const void* data, std::size_t size) {
+    // Empty collections may pass a null pointer, which memcpy does not accept (even to copy nothing)
+    if (size == 0)
+      return;
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    length_ += size;
+    if (buffered_ != 0) {
+      const std::size_t count = std::min(size, sizeof(buffer_) - buffered_);
+      std::memcpy(buffer_ + buffered_, bytes, count);
+      buffered_ += count;
+      bytes += count;
+      size -= count;
+      if (buffered_ < sizeof(buffer_))
+        return;
+      MixWord(buffer_);
+      buffered_ = 0;
+    }
+    for (; size >= sizeof(buffer_); bytes += sizeof(buffer_), size -= sizeof(buffer_))
+      MixWord(bytes);
+    std::memcpy(buffer_, bytes, size);
+    buffered_ = size;
+  }
+
+  std::size_t Finish() const {
+    std::uint64_t state = state_;
+    if (buffered_ != 0) {
+      unsigned char tail[sizeof(buffer_)] = {};
+      std::memcpy(tail, buffer_, buffered_);
+      state = Mix(state, Load(tail));
+    }
+    state ^= length_;
+    state ^= state >> 33;
+    state *= 0xff51afd7ed558ccdULL;
+    state ^= state >> 33;
+    state *= 0xc4ceb9fe1a85ec53ULL;
+    state ^= state >> 33;
+    return static_cast<std::size_t>(state);
+  }
+
+ private:
+  static std::uint64_t Load(const unsigned char* bytes) {
+    std::uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    return word;
+  }
+  static std::uint64_t Mix(std::uint64_t state, std::uint64_t word) {
+    word *= 0x87c37b91114253d5ULL;
+    word = (word << 31) | (word >> 33);
+    word *= 0x4cf5ad432745937fULL;
+    state ^= word;
+    state = (state << 27) | (state >> 37);
+    return state * 5 + 0x52dce729;
+  }
+  void MixWord(const unsigned char* bytes) { state_ = Mix(state_, Load(bytes)); }
+
+  std::uint64_t state_ = 0x9e3779b97f4a7c15ULL;
+  std::uint64_t length_ = 0;
+  unsigned char buffer_[sizeof(std::uint64_t)] = {};
+  std::size_t buffered_ = 0;
+};
+
+template <typename T> void HashElement(ByteHasher& hasher, const T& value, std::true_type /* unique_representation */) {
+  hasher.Update(&value, sizeof(value));
+}
+template <typename T>
+void HashElement(ByteHasher& hasher, const T& value, std::false_type /* unique_representation */) {
+  const std::size_t hash = std::hash<T>{}(value);
+  hasher.Update(&hash, sizeof(hash));
+}
+
+template <typename T> std::size_t HashElements(const T& iterable, std::true_type /* can_hash_bytes */) {
+  ByteHasher hasher;
+  hasher.Update(iterable.data(), iterable.size() * sizeof(*iterable.data()));
+  return hasher.Finish();
+}
+template <typename T> std::size_t HashElements(const T& iterable, std::false_type /* can_hash_bytes */) {
+  ByteHasher hasher;
+  for (const auto& value : iterable) {
+    using _value = remove_cvref_t<decltype(value)>;
+    HashElement(hasher, value, has_unique_representation<_value>{});
+  }
+  return hasher.Finish();
+}
+
+// The number of independent accumulators used to reduce a block of values
+constexpr std::size_t kReduceLanes = 16;
+
+// True if 'ForEachBlock' hands out the elements of 'T' without first copying them one by one into a block,
+// i.e. if all nested collections are contiguous and every mapping-function produces arithmetic values from arithmetic
+// values (or is a block kernel, which needs the values in blocks anyway)
+template <typename T> struct has_native_blocks : is_contiguous_collection<T> {};
+template <typename T> struct has_native_blocks<Iterated<T>> : has_native_blocks<remove_cvref_t<T>> {};
+template <typename T> struct has_native_blocks<ForwardIterated<T>> : has_native_blocks<remove_cvref_t<T>> {};
+template <typename T>
+struct has_native_blocks<Chained<T>> : has_native_blocks<typename remove_cvref_t<T>::value_type> {};
+template <typename T>
+struct has_native_blocks<ForwardChained<T>> : has_native_blocks<typename remove_cvref_t<T>::value_type> {};
+template <typename T1, typename T2>
+struct has_native_blocks<Joined<T1, T2>>
+    : conjunction<has_native_blocks<remove_cvref_t<T1>>, has_native_blocks<remove_cvref_t<T2>>> {};
+template <typename T1, typename T2>
+struct has_native_blocks<ForwardJoined<T1, T2>>
+    : conjunction<has_native_blocks<remove_cvref_t<T1>>, has_native_blocks<remove_cvref_t<T2>>> {};
+template <typename T, typename F> struct has_native_blocks<Filtered<T, F>> : has_native_blocks<remove_cvref_t<T>> {};
+template <typename T, typename F>
+struct has_native_blocks<ForwardFiltered<T, F>> : has_native_blocks<remove_cvref_t<T>> {};
+template <typename T, typename F>
+struct mapped_has_native_blocks
+    : disjunction<is_block_kernel<F>, conjunction<std::is_arithmetic<block_value_t<remove_cvref_t<T>>>,
+                                                  has_native_blocks<remove_cvref_t<T>>>> {};
+template <typename T, typename F> struct has_native_blocks<Mapped<T, F>> : mapped_has_native_blocks<T, F> {};
+template <typename T, typename F> struct has_native_blocks<ForwardMapped<T, F>> : mapped_has_native_blocks<T, F> {};
+
+// True if the elements of 'T' are arithmetic values that are worth reducing a block at a time
+template <typename T>
+using can_reduce_blocks = conjunction<std::is_arithmetic<block_value_t<T>>, has_native_blocks<T>>;
+
+// Reducers accumulate the values one by one through 'Add(value)', or a whole block through 'AddBlock(data, size)'.
+// 'AddBlock' spreads the values over 'kReduceLanes' accumulators, so consecutive values don't depend on each other.
+template <typename T> class SumReducer {
+ public:
+  // The type of 'value + value', so small integers are promoted (to 'int') instead of wrapping around
+  using _sum = remove_cvref_t<decltype(std::declval<const T&>() + std::declval<const T&>())>;
+
+  void Add(const T& value) { sum_ += value; }
+  void AddBlock(const T* values, std::size_t size) {
+    _sum lanes[kReduceLanes] = {};
+    std::size_t i = 0;
+    for (; i + kReduceLanes <= size; i += kReduceLanes) {
+      for (std::size_t lane = 0; lane < kReduceLanes; lane++)
+        lanes[lane] += values[i + lane];
+    }
+    for (; i < size; i++)
+      lanes[0] += values[i];
+    for (const _sum& lane : lanes)
+      sum_ += lane;
+  }
+
+  _sum Result() const { return sum_; }
+
+ private:
+  _sum sum_{};
+};
+
+struct select_min {
+  template <typename T> static const T& Apply(const T& current, const T& value) {
+    return value < current ? value : current;
+  }
+};
+struct select_max {
+  template <typename T> static const T& Apply(const T& current, const T& value) {
+    return current < value ? value : current;
+  }
+};
+
+// Keeps the element picked by '_select' (select_min or select_max)
+template <typename T, typename _select> class ExtremeReducer {
+ public:
+  void Add(const T& value) {
+    extreme_ = empty_ ? value : _select::Apply(extreme_, value);
+    empty_ = false;
+  }
+  void AddBlock(const T* values, std::size_t size) {
+    if (size == 0)
+      return;
+    if (empty_)
+      Add(values[0]);
+    T lanes[kReduceLanes];
+    for (T& lane : lanes)
+      lane = extreme_;
+    std::size_t i = 0;
+    for (; i + kReduceLanes <= size; i += kReduceLanes) {
+      for (std::size_t lane = 0; lane < kReduceLanes; lane++) {
+        const T value = values[i + lane];  // Selecting between values (not references) compiles to min/max
+        lanes[lane] = _select::Apply(lanes[lane], value);
+      }
+    }
+    for (; i < size; i++)
+      extreme_ = _select::Apply(extreme_, values[i]);
+    for (const T& lane : lanes)
+      extreme_ = _select::Apply(extreme_, lane);
+  }
+
+  T Result() const { return extreme_; }
+
+ private:
+  T extreme_{};
+  bool empty_ = true;
+};
+
+template <typename T> class MinMaxReducer {
+ public:
+  void Add(const T& value) {
+    min_.Add(value);
+    max_.Add(value);
+  }
+  void AddBlock(const T* values, std::size_t size) {
+    min_.AddBlock(values, size);
+    max_.AddBlock(values, size);
+  }
+
+  std::pair<T, T> Result() const { return {min_.Result(), max_.Result()}; }
+
+ private:
+  ExtremeReducer<T, select_min> min_;
+  ExtremeReducer<T, select_max> max_;
+};
+
+template <typename T> class CountReducer {
+ public:
+  void Add(const T&) { count_++; }
+  void AddBlock(const T*, std::size_t size) { count_ += size; }
+
+  std::size_t Result() const { return count_; }
+
+ private:
+  std::size_t count_ = 0;
+};
+
+template <typename T, typename Reducer>
+void Reduce(const T& iterable, Reducer& reducer, std::true_type /* can_reduce_blocks */) {
+  using _value = block_value_t<T>;
+  auto reduce_block = [&reducer](Block<const _value> block) {
+    RunVectorized([&reducer, &block]() { reducer.AddBlock(block.data(), block.size()); }, std::true_type{});
+  };
+  details::ForEachBlock(iterable, reduce_block);
+}
+template <typename T, typename Reducer>
+void Reduce(const T& iterable, Reducer& reducer, std::false_type /* can_reduce_blocks */) {
+  auto add = [&reducer](const auto& value) { reducer.Add(value); };
+  details::ForEach(iterable, add);
+}
+
+// Feeds all the elements of 'iterable' to a new '_reducer<value_type>' and returns its result
+template <template <typename> class _reducer, typename T> auto Reduce(const T& iterable) {
+  _reducer<block_value_t<T>> reducer{};
+  details::Reduce(iterable, reducer, can_reduce_blocks<T>{});
+  return reducer.Result();
+}
+
+template <typename T> using min_reducer = ExtremeReducer<T, select_min>;
+template <typename T> using max_reducer = ExtremeReducer<T, select_max>;
+
+template <typename T> std::size_t CountElements(const T& iterable, std::true_type /* has_size */) {
+  return iterable.size();
+}
+template <typename T> std::size_t CountElements(const T& iterable, std::false_type /* has_size */) {
+  return details::Reduce<CountReducer>(iterable);
+}
+}  // namespace details
+
+template <typename T, typename Sink> void ForEach(T&& iterable, Sink sink) { details::ForEach(iterable, sink); }
+
+template <typename T, typename BlockSink> void ForEachBlock(T&& iterable, BlockSink sink) {
+  static_assert(kBlockSize <= 1 << 16, "The selection of a block is stored as 16-bit positions");
+  details::ForEachBlock(details::as_const(iterable), sink);
+}
+
+template <typename Out, typename T, typename Kernel> auto MapBlocks(T&& iterable, Kernel kernel) {
+  return Map(std::forward<T>(iterable), details::BlockKernel<Kernel, Out>{std::move(kernel)});
+}
+
+template <typename T, typename OutputIterator> OutputIterator Copy(const T& iterable, OutputIterator output) {
+  return details::CopyElements(iterable, output, details::can_copy_bytes<T, OutputIterator>{});
+}
+
+template <typename T1, typename T2> bool Equal(const T1& iterable_1, const T2& iterable_2) {
+  return details::EqualElements(iterable_1, iterable_2, details::can_compare_bytes<T1, T2>{});
+}
+
+template <typename T> std::size_t Hash(const T& iterable) {
+  return details::HashElements(iterable, details::can_hash_bytes<T>{});
+}
+
+template <typename T> auto Sum(const T& iterable) { return details::Reduce<details::SumReducer>(iterable); }
+
+template <typename T> auto Min(const T& iterable) { return details::Reduce<details::min_reducer>(iterable); }
+
+template <typename T> auto Max(const T& iterable) { return details::Reduce<details::max_reducer>(iterable); }
+
+template <typename T> auto MinMax(const T& iterable) { return details::Reduce<details::MinMaxReducer>(iterable); }
+
+template <typename T> std::size_t Count(const T& iterable) {
+  return details::CountElements(iterable, std::integral_constant<bool, details::has_size<T>::value>{});
+}
+
+template <typename T, typename Value, typename Function> Value Fold(const T& iterable, Value init, Function function) {
+  auto fold = [&init, &function](const auto& value) { init = function(std::move(init), value); };
+  details::ForEach(iterable, fold);
+  return init;
+}
 }  // namespace iterators
 
 #endif  // _CPP_ITERATORS_ITERATORS_H_
@@ -0,0 +1,460 @@
+
+#include "iterators.h"
+#include <algorithm>
+#include <list>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "benchmark/benchmark.h"
+#if __cplusplus >= 201703L
+#include <optional>
+#endif
+
+namespace iterators {
+namespace {
+
+constexpr int kOuterSize = 1000;
+constexpr int kInnerSize = 100;
+
+bool is_odd(int value) { return (value % 2) != 0; }
+
+std::vector<int> MakeVector(int size) {
+  std::vector<int> result(size);
+  for (int i = 0; i < size; i++)
+    result[i] = i;
+  return result;
+}
+
+std::vector<std::vector<int>> MakeNestedVector() {
+  std::vector<std::vector<int>> result{};
+  for (int i = 0; i < kOuterSize; i++)
+    result.push_back(MakeVector(kInnerSize));
+  return result;
+}
+
+void BM_Chain_Filter_RangeFor(benchmark::State& state) {
+  auto nested = MakeNestedVector();
+  for (auto _ : state) {
+    long sum = 0;
+    for (int value : Chain(nested).filter(is_odd))
+      sum += value;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kOuterSize * kInnerSize);
+}
+BENCHMARK(BM_Chain_Filter_RangeFor);
+
+void BM_Chain_Filter_ForEach(benchmark::State& state) {
+  auto nested = MakeNestedVector();
+  for (auto _ : state) {
+    long sum = 0;
+    Chain(nested).filter(is_odd).for_each([&sum](int value) { sum += value; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kOuterSize * kInnerSize);
+}
+BENCHMARK(BM_Chain_Filter_ForEach);
+
+void BM_Join_RangeFor(benchmark::State& state) {
+  auto first = MakeVector(kOuterSize * kInnerSize);
+  auto second = MakeVector(kOuterSize * kInnerSize);
+  for (auto _ : state) {
+    long sum = 0;
+    for (int value : Join(first, second))
+      sum += value;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * kOuterSize * kInnerSize);
+}
+BENCHMARK(BM_Join_RangeFor);
+
+void BM_Join_ForEach(benchmark::State& state) {
+  auto first = MakeVector(kOuterSize * kInnerSize);
+  auto second = MakeVector(kOuterSize * kInnerSize);
+  for (auto _ : state) {
+    long sum = 0;
+    ForEach(Join(first, second), [&sum](int value) { sum += value; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * kOuterSize * kInnerSize);
+}
+BENCHMARK(BM_Join_ForEach);
+
+void BM_Join_Chain_Map_RangeFor(benchmark::State& state) {
+  auto nested = MakeNestedVector();
+  std::list<int> other(kOuterSize * kInnerSize, 1);
+  for (auto _ : state) {
+    long sum = 0;
+    for (int value : Join(Chain(nested), other).map([](int value) { return value * 2; }))
+      sum += value;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * kOuterSize * kInnerSize);
+}
+BENCHMARK(BM_Join_Chain_Map_RangeFor);
+
+void BM_Join_Chain_Map_ForEach(benchmark::State& state) {
+  auto nested = MakeNestedVector();
+  std::list<int> other(kOuterSize * kInnerSize, 1);
+  for (auto _ : state) {
+    long sum = 0;
+    Join(Chain(nested), other).map([](int value) { return value * 2; }).for_each([&sum](int value) { sum += value; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * kOuterSize * kInnerSize);
+}
+BENCHMARK(BM_Join_Chain_Map_ForEach);
+
+void BM_Map_Map_Filter_Filter_HandwrittenLoop(benchmark::State& state) {
+  auto collection = MakeVector(kOuterSize * kInnerSize);
+  for (auto _ : state) {
+    long sum = 0;
+    for (int value : collection) {
+      int mapped = (value + 1) * 3;
+      if (is_odd(mapped) && mapped % 5 != 0)
+        sum += mapped;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kOuterSize * kInnerSize);
+}
+BENCHMARK(BM_Map_Map_Filter_Filter_HandwrittenLoop);
+
+void BM_Map_Map_Filter_Filter_RangeFor(benchmark::State& state) {
+  auto collection = MakeVector(kOuterSize * kInnerSize);
+  for (auto _ : state) {
+    long sum = 0;
+    auto pipeline = Iterate(collection)
+                        .map([](int value) { return value + 1; })
+                        .map([](int value) { return value * 3; })
+                        .filter([](int value) { return is_odd(value); })
+                        .filter([](int value) { return value % 5 != 0; });
+    for (int value : pipeline)
+      sum += value;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kOuterSize * kInnerSize);
+}
+BENCHMARK(BM_Map_Map_Filter_Filter_RangeFor);
+
+void BM_Map_Map_Filter_Filter_ForEach(benchmark::State& state) {
+  auto collection = MakeVector(kOuterSize * kInnerSize);
+  for (auto _ : state) {
+    long sum = 0;
+    Iterate(collection)
+        .map([](int value) { return value + 1; })
+        .map([](int value) { return value * 3; })
+        .filter([](int value) { return is_odd(value); })
+        .filter([](int value) { return value % 5 != 0; })
+        .for_each([&sum](int value) { sum += value; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kOuterSize * kInnerSize);
+}
+BENCHMARK(BM_Map_Map_Filter_Filter_ForEach);
+
+// Random values, so filtering on 'value < 0.5' keeps half of them in an unpredictable pattern
+std::vector<float> MakeRandomVector(int size) {
+  std::mt19937 generator{42};
+  std::uniform_real_distribution<float> distribution{0, 1};
+  std::vector<float> result(size);
+  for (float& value : result)
+    value = distribution(generator);
+  return result;
+}
+
+constexpr int kRows = 1 << 20;
+
+auto IsSmall = [](float value) { return value < 0.5f; };
+auto Scale = [](float value) { return value * 3.0f + 1.0f; };
+
+void BM_Filter_Map_RangeFor(benchmark::State& state) {
+  auto values = MakeRandomVector(kRows);
+  for (auto _ : state) {
+    float sum = 0;
+    for (float value : Iterate(values).filter(IsSmall).map(Scale))
+      sum += value;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+BENCHMARK(BM_Filter_Map_RangeFor);
+
+void BM_Filter_Map_ForEach(benchmark::State& state) {
+  auto values = MakeRandomVector(kRows);
+  for (auto _ : state) {
+    float sum = 0;
+    Iterate(values).filter(IsSmall).map(Scale).for_each([&sum](float value) { sum += value; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+BENCHMARK(BM_Filter_Map_ForEach);
+
+void BM_Filter_Map_ForEachBlock(benchmark::State& state) {
+  auto values = MakeRandomVector(kRows);
+  for (auto _ : state) {
+    float sum = 0;
+    Iterate(values).filter(IsSmall).map(Scale).for_each_block([&sum](const Block<const float>& block) {
+      for (float value : block)
+        sum += value;
+    });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+BENCHMARK(BM_Filter_Map_ForEachBlock);
+
+void BM_Sum_Iterate_RangeFor(benchmark::State& state) {
+  auto values = MakeRandomVector(kRows);
+  for (auto _ : state) {
+    float sum = 0;
+    for (float value : Iterate(values))
+      sum += value;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+BENCHMARK(BM_Sum_Iterate_RangeFor);
+
+void BM_Sum_Iterate_Sum(benchmark::State& state) {
+  auto values = MakeRandomVector(kRows);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(Iterate(values).sum());
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+BENCHMARK(BM_Sum_Iterate_Sum);
+
+void BM_Max_Iterate_RangeFor(benchmark::State& state) {
+  auto values = MakeRandomVector(kRows);
+  for (auto _ : state) {
+    float max = values[0];
+    for (float value : Iterate(values))
+      max = max < value ? value : max;
+    benchmark::DoNotOptimize(max);
+  }
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+BENCHMARK(BM_Max_Iterate_RangeFor);
+
+void BM_Max_Iterate_Max(benchmark::State& state) {
+  auto values = MakeRandomVector(kRows);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(Iterate(values).max());
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+BENCHMARK(BM_Max_Iterate_Max);
+
+void BM_Sum_Map_RangeFor(benchmark::State& state) {
+  auto values = MakeRandomVector(kRows);
+  for (auto _ : state) {
+    float sum = 0;
+    for (float value : Iterate(values).map(Scale))
+      sum += value;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+BENCHMARK(BM_Sum_Map_RangeFor);
+
+void BM_Sum_Map_Sum(benchmark::State& state) {
+  auto values = MakeRandomVector(kRows);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(Iterate(values).map(Scale).sum());
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+BENCHMARK(BM_Sum_Map_Sum);
+
+auto Product = [](const auto& item) { return item.First() * item.Second(); };
+
+void BM_Sum_Zip_RangeFor(benchmark::State& state) {
+  auto first = MakeRandomVector(kRows);
+  auto second = MakeRandomVector(kRows);
+  for (auto _ : state) {
+    float sum = 0;
+    for (const auto& item : Zip(first, second))
+      sum += Product(item);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+BENCHMARK(BM_Sum_Zip_RangeFor);
+
+void BM_Sum_Zip_Sum(benchmark::State& state) {
+  auto first = MakeRandomVector(kRows);
+  auto second = MakeRandomVector(kRows);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(Zip(first, second).map(Product).sum());
+  state.SetItemsProcessed(state.iterations() * kRows);
+}
+BENCHMARK(BM_Sum_Zip_Sum);
+
+// Attributes with long names, so copying a name (instead of referring to it) allocates
+std::map<std::string, std::vector<int>> MakeAttributes() {
+  std::map<std::string, std::vector<int>> result{};
+  for (int i = 0; i < kOuterSize; i++)
+    result["attribute_with_a_long_name_" + std::to_string(i)] = MakeVector(kInnerSize);
+  return result;
+}
+
+void BM_MapKeys_RangeFor(benchmark::State& state) {
+  const auto attributes = MakeAttributes();
+  for (auto _ : state) {
+    std::size_t size = 0;
+    for (const std::string& name : MapKeys(attributes))
+      size += name.size();
+    benchmark::DoNotOptimize(size);
+  }
+  state.SetItemsProcessed(state.iterations() * kOuterSize);
+}
+BENCHMARK(BM_MapKeys_RangeFor);
+
+void BM_MapValues_RangeFor(benchmark::State& state) {
+  const auto attributes = MakeAttributes();
+  for (auto _ : state) {
+    std::size_t size = 0;
+    for (const std::vector<int>& values : MapValues(attributes))
+      size += values.size();
+    benchmark::DoNotOptimize(size);
+  }
+  state.SetItemsProcessed(state.iterations() * kOuterSize);
+}
+BENCHMARK(BM_MapValues_RangeFor);
+
+std::vector<std::string> MakeNumberStrings() {
+  std::vector<std::string> result{};
+  for (int i = 0; i < kOuterSize * kInnerSize; i++)
+    result.push_back(std::to_string(i * 7919));
+  return result;
+}
+
+// An expensive mapping-function
+int Parse(const std::string& value) { return std::stoi(value); }
+
+void BM_Map_Filter_Parse_RangeFor(benchmark::State& state) {
+  const auto values = MakeNumberStrings();
+  for (auto _ : state) {
+    long sum = 0;
+    for (int value : Iterate(values).map(Parse).filter(is_odd))
+      sum += value;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kOuterSize * kInnerSize);
+}
+BENCHMARK(BM_Map_Filter_Parse_RangeFor);
+
+#if __cplusplus >= 201703L
+void BM_FilterMap_Parse_RangeFor(benchmark::State& state) {
+  const auto values = MakeNumberStrings();
+  auto parse_odd = [](const std::string& value) -> std::optional<int> {
+    const int parsed = Parse(value);
+    return is_odd(parsed) ? std::optional<int>{parsed} : std::nullopt;
+  };
+  for (auto _ : state) {
+    long sum = 0;
+    for (int value : Iterate(values).filter_map(parse_odd))
+      sum += value;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kOuterSize * kInnerSize);
+}
+BENCHMARK(BM_FilterMap_Parse_RangeFor);
+#endif  // __cplusplus >= 201703L
+
+// Iterates the parsed values 3 times (e.g. once to check them, once to output them and once to log them)
+template <typename T> long SumThreeTimes(const T& values) {
+  long sum = 0;
+  for (int pass = 0; pass < 3; pass++) {
+    for (int value : values)
+      sum += value;
+  }
+  return sum;
+}
+
+void BM_Map_Parse_IterateThreeTimes(benchmark::State& state) {
+  const auto values = MakeNumberStrings();
+  for (auto _ : state)
+    benchmark::DoNotOptimize(SumThreeTimes(Iterate(values).map(Parse)));
+  state.SetItemsProcessed(state.iterations() * kOuterSize * kInnerSize);
+}
+BENCHMARK(BM_Map_Parse_IterateThreeTimes);
+
+void BM_Map_Parse_Cache_IterateThreeTimes(benchmark::State& state) {
+  const auto values = MakeNumberStrings();
+  for (auto _ : state)
+    benchmark::DoNotOptimize(SumThreeTimes(Iterate(values).map(Parse).cache()));
+  state.SetItemsProcessed(state.iterations() * kOuterSize * kInnerSize);
+}
+BENCHMARK(BM_Map_Parse_Cache_IterateThreeTimes);
+
+// A view that is kept around, and checked for being empty before each time its few elements are used
+bool is_recent(int value) { return value >= kOuterSize * kInnerSize - 10; }
+
+void BM_Filter_Selective_Empty_RangeFor(benchmark::State& state) {
+  const auto values = MakeVector(kOuterSize * kInnerSize);
+  const auto recent = Filter(values, is_recent);
+  for (auto _ : state) {
+    long sum = 0;
+    if (!recent.empty()) {
+      for (int value : recent)
+        sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(BM_Filter_Selective_Empty_RangeFor);
+
+void BM_Filter_CacheBegin_Selective_Empty_RangeFor(benchmark::State& state) {
+  const auto values = MakeVector(kOuterSize * kInnerSize);
+  const auto recent = Filter(values, is_recent).cache_begin();
+  for (auto _ : state) {
+    long sum = 0;
+    if (!recent.empty()) {
+      for (int value : recent)
+        sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(BM_Filter_CacheBegin_Selective_Empty_RangeFor);
+
+// Shards of consecutive values, so the chained values are sorted
+std::vector<std::vector<int>> MakeSortedShards() {
+  std::vector<std::vector<int>> result = MakeNestedVector();
+  for (int i = 0; i < kOuterSize; i++) {
+    for (int& value : result[i])
+      value += i * kInnerSize;
+  }
+  return result;
+}
+
+constexpr int kSearches = 64;
+
+template <typename T> long LowerBounds(const T& values) {
+  long sum = 0;
+  for (int i = 0; i < kSearches; i++)
+    sum += *std::lower_bound(values.begin(), values.end(), i * (kOuterSize * kInnerSize / kSearches));
+  return sum;
+}
+
+void BM_Chain_LowerBound(benchmark::State& state) {
+  const auto shards = MakeSortedShards();
+  for (auto _ : state)
+    benchmark::DoNotOptimize(LowerBounds(Chain(shards)));
+  state.SetItemsProcessed(state.iterations() * kSearches);
+}
+BENCHMARK(BM_Chain_LowerBound);
+
+void BM_IndexedChain_LowerBound(benchmark::State& state) {
+  const auto shards = MakeSortedShards();
+  for (auto _ : state)
+    benchmark::DoNotOptimize(LowerBounds(IndexedChain(shards)));
+  state.SetItemsProcessed(state.iterations() * kSearches);
+}
+BENCHMARK(BM_IndexedChain_LowerBound);
+
+}  // namespace
+}  // namespace iterators
+
+BENCHMARK_MAIN();
@@ -1,8 +1,15 @@
 
 #include "iterators.h"
+#include <algorithm>
+#include <cctype>
+#include <array>
+#include <cstdint>
 #include <forward_list>
 #include <list>
 #include <memory>
+#include <numeric>
+#include <optional>
+#include <string>
 #include <vector>
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -56,6 +63,7 @@ template <class T> std::string type_name() {
 }
 
 bool is_odd(const int& value) { return (value % 2) != 0; }
+std::string ToString(const int& value) { return std::to_string(value); }
 template <typename T> std::string AnyMappingFunction(const T& value) { return "any-value"; }
 template <typename T> bool AnyFilterFunction(const T& value) { return true; }
 
@@ -223,6 +231,597 @@ TEST(NonConstReverseIterator, SanityCheck) {
   EXPECT_TYPE(vector<int>::const_reverse_iterator, details::non_const_reverse_iterator_t<const vector<int>&>);
 }
 
+TEST(StandardIteratorTest, WorksWithStdDistance) {
+  BiDirectionalCollection<int> vector{1, 2, 3, 4};
+  ForwardOnlyCollection<list<int>> nested{{1, 2}, {}, {3}};
+
+  EXPECT_EQ(4, std::distance(Map(vector, ToString).begin(), Map(vector, ToString).end()));
+  auto filtered = Filter(vector, is_odd);
+  EXPECT_EQ(2, std::distance(filtered.begin(), filtered.end()));
+  auto chained = Chain(nested);
+  EXPECT_EQ(3, std::distance(chained.begin(), chained.end()));
+  auto joined = Join(vector, vector);
+  EXPECT_EQ(8, std::distance(joined.begin(), joined.end()));
+}
+
+TEST(StandardIteratorTest, WorksWithStdCopy) {
+  BiDirectionalCollection<int> first{1, 2, 3};
+  ForwardOnlyCollection<int> second{4, 5};
+  vector<int> result{};
+  auto joined = Join(first, second).filter(is_odd);
+  std::copy(joined.begin(), joined.end(), std::back_inserter(result));
+
+  EXPECT_THAT(result, ElementsAre(1, 3, 5));
+}
+
+TEST(StandardIteratorTest, SupportsPostfixIncrement) {
+  BiDirectionalCollection<int> collection{1, 2, 3};
+  auto mapped = Map(collection, ToString);
+  auto iterator = mapped.begin();
+
+  EXPECT_EQ("1", *iterator++);
+  EXPECT_EQ("2", *iterator);
+  EXPECT_EQ("2", *iterator--);
+  EXPECT_EQ("1", *iterator);
+}
+
+TEST(StandardIteratorTest, SupportsArrowOperator) {
+  BiDirectionalCollection<string> strings{"a", "bb"};
+  BiDirectionalCollection<int> ints{1, 22};
+
+  EXPECT_EQ(2u, std::next(Filter(strings, [](const string&) { return true; }).begin())->size());
+  EXPECT_EQ(2u, std::next(Map(ints, ToString).begin())->size());
+  EXPECT_EQ(1, std::next(Enumerate(strings).begin())->Position());
+  EXPECT_EQ(22, std::next(Zip(strings, ints).begin())->Second());
+}
+
+TEST(StandardIteratorTest, IteratorsAreDefaultConstructibleAndAssignable) {
+  BiDirectionalCollection<int> collection{1, 2, 3};
+  auto filtered = Filter(collection, [](int value) { return value > 1; });
+
+  decltype(filtered)::iterator iterator{};
+  iterator = filtered.begin();
+  EXPECT_EQ(2, *iterator);
+}
+
+TEST(StandardIteratorTest, IterablesCanBeMovedAndAssigned) {
+  int offset = 10;
+  auto add_offset = [offset](int value) { return value + offset; };
+  auto mapped = Iterate(vector<int>{1, 2, 3}).map(add_offset);
+  auto other = Iterate(vector<int>{4}).map(add_offset);
+
+  other = std::move(mapped);
+
+  EXPECT_THAT(other, ElementsAre(11, 12, 13));
+  EXPECT_EQ(3u, other.size());
+}
+
+// Iterators are copied around all the time, so they should only carry what they really need.
+// The budgets below are expressed in the size of the iterator of the nested collection.
+constexpr std::size_t kIteratorSize = sizeof(vector<int>::iterator);
+constexpr std::size_t kPointerSize = sizeof(void*);
+
+TEST(IteratorSizeTest, Iterate) {
+  vector<int> collection{};
+  EXPECT_LE(sizeof(Iterate(collection).begin()), kIteratorSize);
+  EXPECT_LE(sizeof(Reverse(collection).begin()), kIteratorSize);
+}
+
+TEST(IteratorSizeTest, AsReferences) {
+  vector<int*> pointers{};
+  vector<std::unique_ptr<int>> unique_pointers{};
+  EXPECT_LE(sizeof(AsReferences(pointers).begin()), kIteratorSize);
+  EXPECT_LE(sizeof(AsReferences(unique_pointers).begin()), kIteratorSize);
+}
+
+TEST(IteratorSizeTest, Map) {
+  vector<int> collection{};
+  EXPECT_LE(sizeof(Map(collection, ToString).begin()), kIteratorSize + kPointerSize);
+}
+
+TEST(IteratorSizeTest, Filter) {
+  vector<int> collection{};
+  EXPECT_LE(sizeof(Filter(collection, is_odd).begin()), kIteratorSize + kPointerSize);
+}
+
+TEST(IteratorSizeTest, Enumerate) {
+  vector<int> collection{};
+  // Position + the item we hand out by reference
+  EXPECT_LE(sizeof(Enumerate(collection).begin()), kIteratorSize + 2 * sizeof(int) + sizeof(Item<int>));
+}
+
+TEST(IteratorSizeTest, Zip) {
+  vector<int> collection{};
+  // Both collections need their end, as iteration stops at the end of the shortest one
+  EXPECT_LE(sizeof(Zip(collection, collection).begin()), 4 * kIteratorSize + sizeof(ZippedValue<int, int>));
+}
+
+TEST(IteratorSizeTest, Join) {
+  vector<int> collection{};
+  EXPECT_LE(sizeof(Join(collection, collection).begin()), 4 * kIteratorSize);
+}
+
+TEST(IteratorSizeTest, Chain) {
+  vector<vector<int>> collection{};
+  EXPECT_LE(sizeof(Chain(collection).begin()), 4 * kIteratorSize);
+}
+
+TEST(IteratorSizeTest, IndexedChain) {
+  vector<vector<int>> collection{};
+  // The index, the number of nested collections, the current one and the position
+  EXPECT_LE(sizeof(IndexedChain(collection).begin()), 2 * kIteratorSize + kPointerSize + 3 * sizeof(std::size_t));
+}
+
+TEST(IteratorSizeTest, NestedOperatorsDoNotMultiplyTheSize) {
+  vector<int> collection{};
+  auto nested = Enumerate(collection).map([](const auto& item) { return item.Position(); }).filter(is_odd);
+  // The filter also keeps the mapped value of its current element
+  EXPECT_LE(sizeof(nested.begin()), sizeof(Enumerate(collection).begin()) + 2 * kPointerSize + sizeof(std::size_t));
+}
+
+// Returns the values 'ForEach' passes to its sink, so we can compare them to those of a range-based for loop
+template <typename T> auto ForEachValues(T&& iterable) {
+  vector<details::remove_cvref_t<decltype(*std::begin(iterable))>> result{};
+  ForEach(iterable, [&result](const auto& value) { result.push_back(value); });
+  return result;
+}
+
+template <typename T> auto RangeForValues(T&& iterable) {
+  vector<details::remove_cvref_t<decltype(*std::begin(iterable))>> result{};
+  for (const auto& value : iterable)
+    result.push_back(value);
+  return result;
+}
+
+TEST(ForEachTest, VisitsSameValuesAsRangeFor) {
+  vector<int> first{1, 2, 3};
+  ForwardOnlyCollection<int> second{4, 5};
+  ForwardOnlyCollection<list<int>> nested{{1, 2}, {}, {3}, {}};
+
+  EXPECT_THAT(ForEachValues(first), ElementsAre(1, 2, 3));
+  EXPECT_THAT(ForEachValues(Iterate(first)), ElementsAre(1, 2, 3));
+  EXPECT_THAT(ForEachValues(Map(second, ToString)), ElementsAre("4", "5"));
+  EXPECT_THAT(ForEachValues(Filter(first, is_odd)), ElementsAre(1, 3));
+  EXPECT_THAT(ForEachValues(Join(first, second)), ElementsAre(1, 2, 3, 4, 5));
+  EXPECT_THAT(ForEachValues(Chain(nested)), ElementsAre(1, 2, 3));
+  EXPECT_THAT(ForEachValues(Reverse(first)), ElementsAre(3, 2, 1));
+  EXPECT_THAT(ForEachValues(Chain(nested).filter(is_odd).map(ToString)), ElementsAre("1", "3"));
+  EXPECT_EQ(RangeForValues(Join(Chain(nested), first).filter(is_odd)),
+            ForEachValues(Join(Chain(nested), first).filter(is_odd)));
+}
+
+TEST(ForEachTest, Enumerate) {
+  vector<char> collection{'A', 'B', 'C'};
+  vector<string> result{};
+
+  ForEach(Enumerate(collection), [&result](const auto& item) {
+    result.push_back(std::to_string(item.Position()) + std::to_string(item.Value()));
+  });
+
+  EXPECT_THAT(result, ElementsAre("0A", "1B", "2C"));
+}
+
+TEST(ForEachTest, Zip) {
+  vector<int> first{1, 2, 3};
+  ForwardOnlyCollection<char> second{'A', 'B'};
+  vector<string> result{};
+
+  ForEach(Zip(first, second), [&result](const auto& pair) {
+    result.push_back(std::to_string(pair.First()) + std::to_string(pair.Second()));
+  });
+
+  EXPECT_THAT(result, ElementsAre("1A", "2B"));
+}
+
+TEST(ForEachTest, AsReferences) {
+  int one = 1;
+  int two = 2;
+  vector<int*> pointers{&one, &two};
+  vector<std::unique_ptr<int>> unique_pointers{};
+  unique_pointers.push_back(std::make_unique<int>(3));
+
+  EXPECT_THAT(ForEachValues(AsReferences(pointers)), ElementsAre(1, 2));
+  EXPECT_THAT(ForEachValues(AsReferences(unique_pointers)), ElementsAre(3));
+}
+
+TEST(ForEachTest, CanModifyValues) {
+  vector<list<int>> nested{{1, 2}, {3}};
+  vector<int> other{4};
+
+  Join(Chain(nested), other).for_each([](int& value) { value *= 10; });
+  ForEach(Enumerate(other), [](auto& item) { item.Value() += item.Position(); });
+
+  EXPECT_THAT(nested, ElementsAre(ElementsAre(10, 20), ElementsAre(30)));
+  EXPECT_THAT(other, ElementsAre(40));
+}
+
+TEST(ForEachTest, PassesConstValuesForConstCollections) {
+  const vector<int> const_collection{1};
+  vector<int> collection{1};
+  const vector<int*> const_pointers{&collection[0]};
+  auto expect_const = [](auto& value) {
+    static_assert(std::is_const<details::remove_reference_t<decltype(value)>>::value, "Value must be const");
+  };
+
+  ForEach(Iterate(const_collection), expect_const);
+  ForEach(Join(collection, const_collection), expect_const);
+  ForEach(AsReferences(const_pointers), expect_const);
+  const auto chained = Chain(vector<vector<int>>{{1}});
+  chained.for_each(expect_const);
+}
+
+// Returns all the values 'ForEachBlock' hands out, in order
+template <typename T> auto ForEachBlockValues(T&& iterable) {
+  vector<details::remove_cvref_t<decltype(*std::begin(iterable))>> result{};
+  ForEachBlock(iterable, [&result](const auto& block) {
+    EXPECT_LE(block.size(), kBlockSize);
+    result.insert(result.end(), block.begin(), block.end());
+  });
+  return result;
+}
+
+vector<int> MakeValues(int size) {
+  vector<int> result{};
+  for (int i = 0; i < size; i++)
+    result.push_back((i * 7919) % 1000);
+  return result;
+}
+
+TEST(ForEachBlockTest, ContiguousCollectionIsNotCopied) {
+  vector<int> collection = MakeValues(2500);
+  vector<const int*> block_data{};
+  vector<std::size_t> block_sizes{};
+
+  Iterate(collection).for_each_block([&](const auto& block) {
+    block_data.push_back(block.data());
+    block_sizes.push_back(block.size());
+  });
+
+  EXPECT_THAT(block_data, ElementsAre(&collection[0], &collection[1024], &collection[2048]));
+  EXPECT_THAT(block_sizes, ElementsAre(1024u, 1024u, 452u));
+}
+
+TEST(ForEachBlockTest, NonContiguousCollectionIsCopiedInBlocks) {
+  vector<int> values = MakeValues(1500);
+  list<int> collection{values.begin(), values.end()};
+  vector<std::size_t> block_sizes{};
+
+  ForEachBlock(collection, [&](const Block<const int>& block) { block_sizes.push_back(block.size()); });
+
+  EXPECT_THAT(block_sizes, ElementsAre(1024u, 476u));
+  EXPECT_EQ(values, ForEachBlockValues(collection));
+}
+
+TEST(ForEachBlockTest, HandsOutSameValuesAsForEach) {
+  vector<int> values = MakeValues(5000);
+  ForwardOnlyCollection<int> forward_values{values.begin(), values.end()};
+  vector<vector<int>> nested{values, {}, values};
+  auto is_small = [](int value) { return value < 500; };
+  auto scale = [](int value) { return value * 0.5; };
+  auto has_two_digits = [](const string& value) { return value.size() == 2; };
+
+  EXPECT_EQ(ForEachValues(Iterate(values).filter(is_small).map(scale)),
+            ForEachBlockValues(Iterate(values).filter(is_small).map(scale)));
+  EXPECT_EQ(ForEachValues(Map(forward_values, ToString).filter(has_two_digits)),
+            ForEachBlockValues(Map(forward_values, ToString).filter(has_two_digits)));
+  EXPECT_EQ(ForEachValues(Join(Chain(nested), forward_values).filter(is_odd)),
+            ForEachBlockValues(Join(Chain(nested), forward_values).filter(is_odd)));
+  EXPECT_EQ(ForEachValues(Reverse(values).filter(is_small)), ForEachBlockValues(Reverse(values).filter(is_small)));
+  EXPECT_TRUE(ForEachBlockValues(Filter(values, [](int) { return false; })).empty());
+}
+
+TEST(MapBlocksTest, KernelProcessesWholeBlocks) {
+  vector<int> values = MakeValues(3000);
+  int kernel_calls = 0;
+  auto doubled = MapBlocks<long>(values, [&kernel_calls](Block<const int> input, Block<long> output) {
+    kernel_calls++;
+    for (std::size_t i = 0; i < input.size(); i++)
+      output[i] = input[i] * 2L;
+  });
+
+  vector<long> result = ForEachBlockValues(doubled);
+
+  EXPECT_EQ(3, kernel_calls);
+  ASSERT_EQ(values.size(), result.size());
+  for (std::size_t i = 0; i < values.size(); i++)
+    EXPECT_EQ(values[i] * 2L, result[i]);
+}
+
+TEST(MapBlocksTest, CanBeIteratedLikeAnyMap) {
+  vector<int> values{1, 2, 3};
+  auto kernel = [](auto input, auto output) {
+    for (std::size_t i = 0; i < input.size(); i++)
+      output[i] = std::to_string(input[i]);
+  };
+
+  EXPECT_THAT(MapBlocks<string>(values, kernel), ElementsAre("1", "2", "3"));
+  EXPECT_THAT(Iterate(values).map_blocks<string>(kernel).filter([](const string& value) { return value != "2"; }),
+              ElementsAre("1", "3"));
+}
+
+TEST(MapBlocksTest, IsNotFusedWithOtherMaps) {
+  vector<int> values = MakeValues(2000);
+  int kernel_calls = 0;
+  auto pipeline = Iterate(values)
+                      .map([](int value) { return value + 1; })
+                      .map_blocks<int>([&kernel_calls](Block<const int> input, Block<int> output) {
+                        kernel_calls++;
+                        std::copy(input.begin(), input.end(), output.begin());
+                      })
+                      .map([](int value) { return value - 1; });
+
+  EXPECT_EQ(values, ForEachBlockValues(pipeline));
+  EXPECT_EQ(2, kernel_calls);
+}
+
+TEST(SumTest, SumsAllElements) {
+  vector<int> values(2000);
+  std::iota(values.begin(), values.end(), 1);
+  int expected = std::accumulate(values.begin(), values.end(), 0);
+
+  EXPECT_EQ(expected, Sum(values));
+  EXPECT_EQ(expected, Iterate(values).sum());
+  EXPECT_EQ(expected, Sum(list<int>(values.begin(), values.end())));
+  EXPECT_EQ(2 * expected, Iterate(values).map([](int value) { return 2 * value; }).sum());
+  EXPECT_EQ(1000 * 1000, Iterate(values).filter([](int value) { return value % 2 != 0; }).sum());
+}
+
+TEST(SumTest, ReturnsValueOfMappedType) {
+  vector<int> values{{1, 2, 3}};
+  auto halves = Iterate(values).map([](int value) { return value / 2.0; });
+
+  EXPECT_TYPE(double, decltype(halves.sum()));
+  EXPECT_DOUBLE_EQ(3.0, halves.sum());
+  EXPECT_EQ("abc", Sum(vector<string>{{"a", "b", "c"}}));
+}
+
+TEST(SumTest, PromotesSmallIntegers) {
+  vector<std::uint8_t> bytes(300, 1);
+
+  EXPECT_TYPE(int, decltype(Sum(bytes)));
+  EXPECT_EQ(300, Sum(bytes));
+  EXPECT_EQ(300, Iterate(bytes).sum());
+  EXPECT_EQ(300, Sum(list<std::uint8_t>(bytes.begin(), bytes.end())));
+}
+
+TEST(SumTest, OverEmptyCollection) {
+  EXPECT_EQ(0, Sum(vector<int>{}));
+  EXPECT_EQ(0, Sum(list<int>{}));
+}
+
+TEST(MinMaxTest, ReturnsSmallestAndLargestElement) {
+  vector<int> values(2000);
+  std::iota(values.begin(), values.end(), 1);
+  std::swap(values[0], values[1500]);
+  std::swap(values[1999], values[700]);
+
+  EXPECT_EQ(1, Min(values));
+  EXPECT_EQ(2000, Max(values));
+  EXPECT_EQ(std::make_pair(1, 2000), MinMax(values));
+  EXPECT_EQ(std::make_pair(1, 2000), MinMax(list<int>(values.begin(), values.end())));
+  EXPECT_EQ(-2000, Iterate(values).map([](int value) { return -value; }).min());
+  EXPECT_EQ(1999, Iterate(values).filter([](int value) { return value % 2 != 0; }).max());
+  auto first_half = Iterate(values).filter([](int value) { return value <= 1000; });
+  EXPECT_EQ(std::make_pair(2, 1001), std::move(first_half).map([](int value) { return value + 1; }).minmax());
+}
+
+TEST(MinMaxTest, ReturnsFirstOfEqualElements) {
+  vector<std::pair<int, int>> values{{{2, 0}, {1, 1}, {3, 2}, {1, 3}, {3, 4}}};
+  auto first = Iterate(values).map([](const std::pair<int, int>& value) { return value.first; });
+
+  EXPECT_EQ(std::make_pair(1, 1), Min(values));
+  EXPECT_EQ(std::make_pair(3, 4), Max(values));
+  EXPECT_EQ(std::make_pair(1, 3), first.minmax());
+}
+
+TEST(MinMaxTest, OverEmptyCollection) {
+  EXPECT_EQ(0, Min(vector<int>{}));
+  EXPECT_EQ(0, Max(list<int>{}));
+}
+
+TEST(CountTest, CountsAllElements) {
+  vector<int> values(2000);
+  std::iota(values.begin(), values.end(), 1);
+
+  EXPECT_EQ(2000, Count(values));
+  EXPECT_EQ(2000, Count(ForwardOnlyCollection<int>(values.begin(), values.end())));
+  EXPECT_EQ(1000, Iterate(values).filter([](int value) { return value % 2 != 0; }).count());
+  EXPECT_EQ(0, Count(list<string>{}));
+}
+
+TEST(FoldTest, CombinesAllElementsInOrder) {
+  vector<string> values{{"a", "b", "c"}};
+  auto join = [](string result, const string& value) { return result.empty() ? value : result + "," + value; };
+
+  EXPECT_EQ("a,b,c", Fold(values, string{}, join));
+  EXPECT_EQ("c,b,a", Reverse(values).fold(string{}, join));
+  EXPECT_EQ(24, Fold(list<int>{{2, 3, 4}}, 1, [](int result, int value) { return result * value; }));
+}
+
+TEST(SplitTest, SplitsCollectionsInHalves) {
+  vector<int> values{{1, 2, 3, 4, 5}};
+  ForwardOnlyCollection<int> forward_values{{1, 2, 3}};
+  auto halves = Iterate(values).split();
+  auto forward_halves = Iterate(forward_values).split_at(1);
+
+  EXPECT_THAT(halves.first, ElementsAre(1, 2));
+  EXPECT_THAT(halves.second, ElementsAre(3, 4, 5));
+  EXPECT_THAT(forward_halves.first, ElementsAre(1));
+  EXPECT_THAT(forward_halves.second, ElementsAre(2, 3));
+  EXPECT_THAT(Reverse(values).split().first, ElementsAre(5, 4));
+}
+
+TEST(SplitTest, HalvesCanModifyValues) {
+  vector<int> values{{1, 2, 3, 4}};
+  auto halves = Iterate(values).split();
+  for (int& value : halves.second)
+    value = 0;
+
+  EXPECT_THAT(values, ElementsAre(1, 2, 0, 0));
+}
+
+TEST(SplitTest, HalvesCanBeSplitAgain) {
+  vector<int> values(100);
+  std::iota(values.begin(), values.end(), 0);
+  auto halves = Map(values, [](int value) { return value * 2; }).split();
+  auto quarters = halves.second.split();
+
+  EXPECT_EQ(25, quarters.first.size());
+  EXPECT_EQ(25, quarters.second.split_size());
+  EXPECT_EQ(150, *quarters.second.begin());
+}
+
+TEST(SplitTest, SplitsFilterAtPositionOfNestedCollection) {
+  vector<int> values{{1, 2, 3, 5, 7, 9}};
+  auto halves = Iterate(values).filter([](int value) { return value % 2 != 0; }).split();
+
+  EXPECT_THAT(halves.first, ElementsAre(1, 3));
+  EXPECT_THAT(halves.second, ElementsAre(5, 7, 9));
+}
+
+TEST(SplitTest, SplitsJoinAcrossBothCollections) {
+  list<int> first{{1, 2, 3}};
+  list<int> second{{4, 5}};
+
+  EXPECT_THAT(Join(first, second).split_at(1).second, ElementsAre(2, 3, 4, 5));
+  EXPECT_THAT(Join(first, second).split_at(4).first, ElementsAre(1, 2, 3, 4));
+  EXPECT_THAT(Join(first, second).split_at(4).second, ElementsAre(5));
+}
+
+TEST(SplitTest, SplitsChainByNestedCollection) {
+  vector<vector<int>> collections{{1}, {2, 3}, {4, 5, 6}};
+  auto halves = Chain(collections).split();
+
+  EXPECT_THAT(halves.first, ElementsAre(1));
+  EXPECT_THAT(halves.second, ElementsAre(2, 3, 4, 5, 6));
+}
+
+TEST(SplitTest, EnumerateKeepsPositions) {
+  vector<char> values{{'A', 'B', 'C', 'D', 'E'}};
+  auto halves = Enumerate(values).split();
+  vector<int> positions{};
+  for (const auto& item : halves.second)
+    positions.push_back(item.Position());
+  vector<int> reverse_positions{};
+  for (const auto& item : Reverse(halves.second))
+    reverse_positions.push_back(item.Position());
+
+  EXPECT_THAT(positions, ElementsAre(2, 3, 4));
+  EXPECT_THAT(reverse_positions, ElementsAre(4, 3, 2));
+  EXPECT_EQ('C', halves.second.begin()->Value());
+}
+
+TEST(SplitTest, EnumerateCountsElementsOfFilteredHalf) {
+  vector<int> values{{1, 2, 3, 5, 6, 7}};
+  auto halves = Iterate(values).filter([](int value) { return value % 2 != 0; }).enumerate().split();
+  vector<int> positions{};
+  halves.second.for_each([&positions](const auto& item) { positions.push_back(item.Position()); });
+
+  EXPECT_THAT(positions, ElementsAre(2, 3));
+}
+
+TEST(SplitTest, ZipKeepsBothSidesAligned) {
+  vector<int> first{{1, 2, 3, 4, 5, 6}};
+  list<char> second{{'A', 'B', 'C', 'D'}};
+  auto halves = Zip(first, second).split();
+  vector<string> pairs{};
+  for (const auto& value : halves.second)
+    pairs.push_back(std::to_string(value.First()) + value.Second());
+
+  EXPECT_EQ(2, halves.first.size());
+  EXPECT_THAT(pairs, ElementsAre("3C", "4D"));
+}
+
+#if defined(__cpp_lib_ranges)
+TEST(RangesTest, IteratorsModelTheMatchingConcepts) {
+  vector<int> vector{};
+  ForwardOnlyCollection<int> forward_list{};
+  ForwardOnlyCollection<list<int>> nested{};
+
+  static_assert(std::random_access_iterator<decltype(Map(vector, ToString).begin())>);
+  static_assert(std::random_access_iterator<decltype(AsReferences(std::vector<int*>{}).begin())>);
+  static_assert(std::bidirectional_iterator<decltype(Enumerate(vector).begin())>);
+  static_assert(std::bidirectional_iterator<decltype(Zip(vector, vector).begin())>);
+  static_assert(std::bidirectional_iterator<decltype(Filter(vector, is_odd).begin())>);
+  static_assert(std::forward_iterator<decltype(Map(forward_list, ToString).begin())>);
+  static_assert(std::forward_iterator<decltype(Chain(nested).begin())>);
+  static_assert(std::forward_iterator<decltype(Join(vector, forward_list).begin())>);
+}
+
+TEST(RangesTest, IterablesModelView) {
+  vector<int> vector{};
+
+  static_assert(std::ranges::view<decltype(Iterate(vector))>);
+  static_assert(std::ranges::view<decltype(Map(vector, [](int value) { return value; }))>);
+  static_assert(std::ranges::view<decltype(Filter(vector, [vector](int) { return true; }))>);
+  static_assert(std::ranges::view<decltype(Enumerate(vector))>);
+  static_assert(std::ranges::view<decltype(Reverse(vector))>);
+  static_assert(std::ranges::view<decltype(Zip(vector, vector))>);
+  static_assert(std::ranges::view<decltype(Join(vector, vector))>);
+  static_assert(std::ranges::view<decltype(Chain(std::vector<std::vector<int>>{}))>);
+  static_assert(std::ranges::view<decltype(Chain(std::vector<std::vector<int>>{}).cache_begin())>);
+  static_assert(std::ranges::sized_range<decltype(Map(vector, ToString))>);
+}
+
+TEST(RangesTest, WorksWithRangesAlgorithms) {
+  vector<int> collection{5, 1, 4, 2, 3};
+  vector<int> result{};
+
+  std::ranges::copy(Filter(collection, is_odd), std::back_inserter(result));
+  EXPECT_THAT(result, ElementsAre(5, 1, 3));
+  EXPECT_EQ(3, std::ranges::distance(Filter(collection, is_odd)));
+  auto mapped = Map(collection, ToString);
+  EXPECT_EQ("5", *std::ranges::max_element(mapped));
+}
+#endif
+
+TEST(CopyTest, CopiesContiguousCollection) {
+  vector<int> collection{1, 2, 3};
+  int output[3] = {};
+
+  int* end = Copy(Iterate(collection), output);
+
+  EXPECT_EQ(output + 3, end);
+  EXPECT_THAT(output, ElementsAre(1, 2, 3));
+}
+
+TEST(CopyTest, CopiesNonContiguousCollection) {
+  ForwardOnlyCollection<int> collection{1, 2, 3};
+  vector<string> output{};
+
+  Copy(Map(collection, ToString), std::back_inserter(output));
+
+  EXPECT_THAT(output, ElementsAre("1", "2", "3"));
+}
+
+TEST(EqualTest, ComparesContiguousCollections) {
+  const std::array<int, 3> array{{1, 2, 3}};
+
+  EXPECT_TRUE(Equal(Iterate(vector<int>{1, 2, 3}), array));
+  EXPECT_FALSE(Equal(Iterate(vector<int>{1, 2, 4}), array));
+  EXPECT_FALSE(Equal(Iterate(vector<int>{1, 2}), array));
+  EXPECT_TRUE(Equal(vector<int>{}, vector<int>{}));
+}
+
+TEST(EqualTest, ComparesNonContiguousCollections) {
+  EXPECT_TRUE(Equal(list<int>{1, 2, 3}, vector<int>{1, 2, 3}));
+  EXPECT_FALSE(Equal(list<int>{1, 2, 3}, vector<int>{1, 2}));
+  EXPECT_FALSE(Equal(vector<int>{1, 2}, list<int>{1, 2, 3}));
+  EXPECT_TRUE(Equal(vector<string>{"1", "2"}, Map(list<int>{1, 2}, ToString)));
+}
+
+TEST(HashTest, DependsOnlyOnTheElements) {
+  vector<int> collection{1, 2, 3, 4, 5};
+
+  EXPECT_EQ(Hash(collection), Hash(Iterate(collection)));
+  EXPECT_EQ(Hash(collection), Hash(list<int>{1, 2, 3, 4, 5}));
+  EXPECT_EQ(Hash(collection), Hash(ForwardOnlyCollection<int>{1, 2, 3, 4, 5}));
+  EXPECT_EQ(Hash(vector<string>{"a", "b"}), Hash(list<string>{"a", "b"}));
+  EXPECT_NE(Hash(collection), Hash(vector<int>{1, 2, 3, 4, 6}));
+  EXPECT_NE(Hash(collection), Hash(vector<int>{1, 2, 3, 4}));
+  EXPECT_NE(Hash(vector<int>{}), Hash(vector<int>{0}));
+}
+
 template <typename _Enumerator> string FormatEnumerate(const _Enumerator& iterable) {
   string result{};
   for (const auto& item : iterable)
@@ -309,6 +908,19 @@ TEST(EnumerateTest, OverRvalueConstCollection) {
   EXPECT_TYPE(Item<char>, decltype(iterator)::value_type);
 }
 
+TEST(EnumerateTest, OverFilterOfConstValues) {
+  // The non-const iterator of the filter returns const values, so it must be the const_iterator
+  BiDirectionalCollection<char> collection{'A', 'B', 'C'};
+  auto iterator = Iterate(std::as_const(collection)).filter([](char value) { return value != 'B'; }).enumerate();
+
+  TEST_NON_CONST_ITERATOR(iterator, Item<char> const&);
+  TEST_CONST_ITERATOR(iterator, Item<char> const&);
+  std::vector<std::pair<int, char>> items{};
+  for (const auto& item : iterator)
+    items.emplace_back(item.Position(), item.Value());
+  EXPECT_THAT(items, ElementsAre(std::make_pair(0, 'A'), std::make_pair(1, 'C')));
+}
+
 TEST(EnumerateTest, WorksOnInitializerList) {
   std::initializer_list<char> collection{'A', 'B', 'C'};
   auto iterator = Enumerate(std::move(collection));
@@ -325,6 +937,43 @@ TEST(EnumerateTest, CanChainOperators) {
   TEST_BIDIRECTIONAL_CHAINED_OPERATORS(bidirectional_iterator);
 }
 
+TEST(EnumerateTest, SupportsRandomAccess) {
+  BiDirectionalCollection<char> collection{'A', 'B', 'C', 'D'};
+  auto iterator = Enumerate(collection);
+  auto begin = iterator.begin();
+
+  EXPECT_TYPE(std::random_access_iterator_tag, std::iterator_traits<decltype(begin)>::iterator_category);
+  EXPECT_EQ(4, iterator.end() - begin);
+  EXPECT_EQ(2, begin[2].Position());
+  EXPECT_EQ('C', begin[2].Value());
+  EXPECT_EQ('D', (*(begin + 3)).Value());
+  EXPECT_TRUE(begin < iterator.end());
+  EXPECT_EQ(2, (*(iterator.end() - 2)).Position());
+
+  auto found = std::lower_bound(iterator.begin(), iterator.end(), 'C',
+                                [](const auto& item, char value) { return item.Value() < value; });
+  EXPECT_EQ(2, (*found).Position());
+}
+
+TEST(EnumerateTest, StepsBackFromEndOfBidirectionalCollection) {
+  list<int> collection{10, 20, 30};
+  auto iterator = Enumerate(collection);
+
+  EXPECT_TYPE(std::bidirectional_iterator_tag, std::iterator_traits<decltype(iterator.begin())>::iterator_category);
+  auto last = --iterator.end();
+  EXPECT_EQ(2, last->Position());
+  EXPECT_EQ(30, last->Value());
+  EXPECT_EQ(1, std::prev(std::as_const(iterator).end(), 2)->Position());
+  EXPECT_EQ(2, std::prev(Enumerate(list<int>{10, 20, 30}).end())->Position());
+}
+
+TEST(EnumerateTest, ForwardOnlyCollectionIsNotRandomAccess) {
+  ForwardOnlyCollection<char> collection{'A', 'B', 'C'};
+  auto iterator = Enumerate(collection);
+
+  EXPECT_TYPE(std::forward_iterator_tag, std::iterator_traits<decltype(iterator.begin())>::iterator_category);
+}
+
 TEST(EnumerateReverseTest, ReturnsCorrectValues) {
   BiDirectionalCollection<char> collection{'A', 'B', 'C'};
   auto iterator = Reverse(Enumerate(collection));
@@ -333,6 +982,16 @@ TEST(EnumerateReverseTest, ReturnsCorrectValues) {
   EXPECT_EQ("2: C, 1: B, 0: A, ", FormatEnumerate(std::as_const(iterator)));
 }
 
+TEST(EnumerateReverseTest, SupportsRandomAccess) {
+  BiDirectionalCollection<char> collection{'A', 'B', 'C', 'D'};
+  auto iterator = Reverse(Enumerate(collection));
+  auto begin = iterator.begin();
+
+  EXPECT_EQ(4, iterator.end() - begin);
+  EXPECT_EQ(1, begin[2].Position());
+  EXPECT_EQ('B', begin[2].Value());
+}
+
 TEST(EnumerateReverseTest, CanModifyValues) {
   BiDirectionalCollection<char> collection{'A', 'B', 'C'};
   auto iterator = Enumerate(collection);
@@ -457,6 +1116,27 @@ TEST(IterateTest, CanChainOperators) {
   TEST_BIDIRECTIONAL_CHAINED_OPERATORS(bidirectional_iterator);
 }
 
+TEST(IterateTest, ExposesContiguousStorage) {
+  vector<int> vector{1, 2, 3};
+  const std::array<int, 3> array{{1, 2, 3}};
+  string text{"abc"};
+
+  EXPECT_EQ(vector.data(), Iterate(vector).data());
+  EXPECT_EQ(array.data(), Iterate(array).Data());
+  EXPECT_EQ(text.data(), Iterate(text).data());
+  EXPECT_TYPE(const int*, decltype(Iterate(array).data()));
+  static_assert(details::is_contiguous_collection<decltype(Iterate(vector))>::value, "vector is contiguous");
+  static_assert(details::is_contiguous_collection<decltype(Iterate(text))>::value, "string is contiguous");
+  static_assert(!details::is_contiguous_collection<decltype(Iterate(list<int>{}))>::value, "list is not contiguous");
+  static_assert(!details::is_contiguous_collection<decltype(AsReferences(std::vector<int*>{}))>::value,
+                "referents of pointers are not contiguous");
+#if defined(__cpp_lib_span)
+  std::span<int> span = Iterate(vector).AsSpan();
+  EXPECT_EQ(vector.data(), span.data());
+  EXPECT_EQ(3u, span.size());
+#endif
+}
+
 TEST(IterateReverseTest, ReturnsCorrectValues) {
   BiDirectionalCollection<int> collection{1, 3, 5};
   auto iterator = Reverse(Iterate(collection));
@@ -570,6 +1250,15 @@ TEST(ReverseTest, CanChainOperators) {
   TEST_BIDIRECTIONAL_CHAINED_OPERATORS(bidirectional_iterator);
 }
 
+TEST(ReverseTest, SupportsRandomAccess) {
+  BiDirectionalCollection<int> collection{1, 3, 5, 7};
+  auto iterator = Reverse(collection);
+
+  EXPECT_EQ(3, iterator.begin()[2]);
+  auto found = std::lower_bound(iterator.begin(), iterator.end(), 3, std::greater<int>());
+  EXPECT_EQ(2, found - iterator.begin());
+}
+
 TEST(ReverseReverseTest, ReturnsCorrectValues) {
   BiDirectionalCollection<int> collection{1, 3, 5};
   auto iterator = Reverse(Reverse(collection));
@@ -578,6 +1267,15 @@ TEST(ReverseReverseTest, ReturnsCorrectValues) {
   EXPECT_THAT(std::as_const(iterator), ElementsAre(1, 3, 5));
 }
 
+TEST(ReverseReverseTest, DoubleReverseIteratesTheOriginalCollection) {
+  BiDirectionalCollection<int> collection{1, 3, 5};
+
+  EXPECT_TYPE(Iterated<BiDirectionalCollection<int>&>, decltype(Reverse(Reverse(collection))));
+  EXPECT_TYPE(Iterated<BiDirectionalCollection<int>>, decltype(Reverse(BiDirectionalCollection<int>{}).reverse()));
+  EXPECT_THAT(Reverse(Reverse(BiDirectionalCollection<int>{1, 3, 5})), ElementsAre(1, 3, 5));
+  EXPECT_EQ(3u, Reverse(Reverse(collection)).size());
+}
+
 TEST(ReverseReverseTest, CanModifyValues) {
   BiDirectionalCollection<int> collection{1, 3, 5};
   auto iterator = Reverse(collection);
@@ -804,8 +1502,6 @@ TEST(JoinReverseTest, JoinRvalueCollections) {
   EXPECT_TYPE(int, decltype(iterator)::value_type);
 }
 
-std::string ToString(const int& value) { return std::to_string(value); }
-
 TEST(MapTest, ReturnsCorrectValues) {
   ForwardOnlyCollection<int> collection{1, 3, 5};
   auto iterator = Map(collection, ToString);
@@ -887,6 +1583,63 @@ TEST(MapTest, CanChainOperators) {
   TEST_BIDIRECTIONAL_CHAINED_OPERATORS(bidirectional_iterator);
 }
 
+TEST(MapTest, SupportsRandomAccess) {
+  BiDirectionalCollection<int> collection{1, 3, 5, 7};
+  auto iterator = Map(collection, [](int value) { return value * 10; });
+  auto begin = iterator.begin();
+
+  EXPECT_TYPE(std::random_access_iterator_tag, std::iterator_traits<decltype(begin)>::iterator_category);
+  EXPECT_EQ(4, iterator.end() - begin);
+  EXPECT_EQ(50, begin[2]);
+  EXPECT_EQ(70, *(begin + 3));
+  EXPECT_EQ(30, *(iterator.end() - 3));
+  EXPECT_TRUE(begin < iterator.end());
+  EXPECT_TRUE(begin <= begin);
+  EXPECT_FALSE(begin > begin);
+
+  auto found = std::lower_bound(iterator.begin(), iterator.end(), 50);
+  EXPECT_EQ(2, found - begin);
+  EXPECT_TRUE(std::binary_search(iterator.begin(), iterator.end(), 70));
+}
+
+TEST(MapTest, ForwardOnlyCollectionIsNotRandomAccess) {
+  auto iterator = Map(ForwardOnlyCollection<int>{}, ToString);
+
+  EXPECT_TYPE(std::forward_iterator_tag, std::iterator_traits<decltype(iterator.begin())>::iterator_category);
+}
+
+// True if 'T' is a single Mapped class directly over 'Collection'
+template <typename T, typename Collection> struct is_mapped_over : std::false_type {};
+template <typename Collection, typename F> struct is_mapped_over<Mapped<Collection, F>, Collection> : std::true_type {};
+template <typename Collection, typename F>
+struct is_mapped_over<ForwardMapped<Collection, F>, Collection> : std::true_type {};
+
+TEST(MapTest, ConsecutiveMapsAreFused) {
+  BiDirectionalCollection<int> collection{1, 2, 3};
+  auto mapped = Map(collection, [](int value) { return value * 10; }).map(ToString);
+
+  EXPECT_THAT(mapped, ElementsAre("10", "20", "30"));
+  EXPECT_THAT(Reverse(mapped), ElementsAre("30", "20", "10"));
+  EXPECT_EQ(3u, mapped.size());
+  static_assert(is_mapped_over<decltype(mapped), BiDirectionalCollection<int>&>::value, "Maps must be fused");
+}
+
+TEST(MapTest, ConsecutiveMapsAreFusedOverRvalueCollection) {
+  auto mapped = Map(ForwardOnlyCollection<int>{1, 2}, [](int value) { return value * 10; }).map(ToString);
+
+  EXPECT_THAT(mapped, ElementsAre("10", "20"));
+  static_assert(is_mapped_over<decltype(mapped), ForwardOnlyCollection<int>>::value, "Maps must be fused");
+}
+
+TEST(MapTest, NamedMappedCollectionIsNotFused) {
+  BiDirectionalCollection<int> collection{1, 2, 3};
+  auto first = Map(collection, [](int value) { return value * 10; });
+  auto second = Map(first, ToString);
+
+  EXPECT_THAT(second, ElementsAre("10", "20", "30"));
+  EXPECT_THAT(first, ElementsAre(10, 20, 30));
+}
+
 TEST(MapReverseTest, ReturnsCorrectValues) {
   BiDirectionalCollection<int> collection{1, 3, 5};
   auto iterator = Reverse(Map(collection, ToString));
@@ -895,6 +1648,14 @@ TEST(MapReverseTest, ReturnsCorrectValues) {
   EXPECT_THAT(std::as_const(iterator), ElementsAre("5", "3", "1"));
 }
 
+TEST(MapReverseTest, SupportsRandomAccess) {
+  BiDirectionalCollection<int> collection{1, 3, 5, 7};
+  auto iterator = Reverse(Map(collection, ToString));
+
+  EXPECT_EQ(4, iterator.end() - iterator.begin());
+  EXPECT_EQ("3", iterator.begin()[2]);
+}
+
 TEST(MapReverseTest, CanModifyValues) {
   // Note: For map, the non-const version means we send a non-const value into the mapping function
   BiDirectionalCollection<int> collection{1, 3, 5};
@@ -952,6 +1713,44 @@ TEST(MapTest, MapValues__extract_values_from_std_map) {
   EXPECT_THAT(MapValues(input), ElementsAre(1, 2));
 }
 
+TEST(MapTest, MapKeysAndValues__return_references_into_std_map) {
+  std::map<string, std::unique_ptr<int>> input{};
+  input["a"] = std::make_unique<int>(1);
+  input["b"] = std::make_unique<int>(2);
+  auto keys = MapKeys(input);
+  auto values = MapValues(input);
+
+  EXPECT_TYPE(const string&, decltype(*keys.begin()));
+  EXPECT_TYPE(string, decltype(keys)::value_type);
+  EXPECT_EQ(&input.begin()->first, &*keys.begin());
+  EXPECT_EQ(&input.begin()->second, &*values.begin());
+  EXPECT_EQ(2, **std::next(values.begin()));
+  EXPECT_EQ(&input.rbegin()->second, &*Reverse(values).begin());
+}
+
+TEST(MapTest, MapKeys__of_temporary_pairs_returns_values) {
+  vector<int> input{1, 2};
+  auto keys = MapKeys(Map(input, [](int value) { return std::make_pair(ToString(value), value); }));
+
+  EXPECT_TYPE(string, decltype(*keys.begin()));
+  EXPECT_THAT(keys, ElementsAre("1", "2"));
+}
+
+TEST(MapTest, ReturnsReferenceOfMappingFunction) {
+  struct Big {
+    string name;
+    vector<int> data;
+  };
+  vector<Big> input{{"a", {1}}, {"b", {2}}};
+  auto names = Map(input, [](const Big& big) -> const string& { return big.name; });
+
+  EXPECT_TYPE(const string&, decltype(*names.begin()));
+  EXPECT_TYPE(string, decltype(names)::value_type);
+  EXPECT_EQ(&input[1].name, &*++names.begin());
+  EXPECT_EQ(&input[0].name, names.begin().operator->());
+  EXPECT_THAT(names, ElementsAre("a", "b"));
+}
+
 TEST(FilterTest, ReturnsCorrectValues) {
   ForwardOnlyCollection<int> collection{1, 2, 3, 4, 5};
   auto iterator = Filter(collection, is_odd);
@@ -1035,6 +1834,19 @@ TEST(FilterTest, FilterRvalueCollection) {
   EXPECT_TYPE(int, decltype(iterator)::value_type);
 }
 
+TEST(FilterTest, SeesChangesToNestedCollection) {
+  vector<int> collection{1, 2, 3, 4};
+  const auto iterator = Filter(collection, [](int value) { return value > 2; });
+
+  EXPECT_EQ(2u, iterator.size());
+  collection.push_back(5);
+  EXPECT_EQ(3u, iterator.size());
+  EXPECT_THAT(iterator, ElementsAre(3, 4, 5));
+  collection.resize(2);
+  EXPECT_TRUE(iterator.empty());
+  EXPECT_THAT(iterator, ElementsAre());
+}
+
 TEST(FilterTest, CanChainOperators) {
   auto forward_iterator = Filter(ForwardOnlyCollection<int>{}, is_odd);
   auto bidirectional_iterator = Filter(BiDirectionalCollection<int>{}, is_odd);
@@ -1042,6 +1854,24 @@ TEST(FilterTest, CanChainOperators) {
   TEST_BIDIRECTIONAL_CHAINED_OPERATORS(bidirectional_iterator);
 }
 
+TEST(FilterTest, IsBidirectionalButNotRandomAccess) {
+  auto iterator = Filter(BiDirectionalCollection<int>{}, is_odd);
+
+  EXPECT_TYPE(std::bidirectional_iterator_tag, std::iterator_traits<decltype(iterator.begin())>::iterator_category);
+}
+
+TEST(FilterTest, CanDecrement) {
+  BiDirectionalCollection<int> collection{1, 2, 3, 4, 5, 6};
+  auto iterator = Filter(collection, is_odd);
+
+  auto last = iterator.end();
+  --last;
+  EXPECT_EQ(5, *last);
+  EXPECT_EQ(5, *last--);
+  EXPECT_EQ(3, *last);
+  EXPECT_EQ(3, *std::prev(iterator.end(), 2));
+}
+
 TEST(FilterTest, WorksOnRValues) {
   auto rvalue_collection =
       Map(BiDirectionalCollection<char>{'A', 'B', 'C'}, [](const char& value) { return std::to_string(value); });
@@ -1051,6 +1881,28 @@ TEST(FilterTest, WorksOnRValues) {
   EXPECT_THAT(values, ElementsAre("A", "C"));
 }
 
+// True if 'T' is a single Filtered class directly over 'Collection'
+template <typename T, typename Collection> struct is_filtered_over : std::false_type {};
+template <typename Collection, typename F>
+struct is_filtered_over<Filtered<Collection, F>, Collection> : std::true_type {};
+
+TEST(FilterTest, ConsecutiveFiltersAreMerged) {
+  BiDirectionalCollection<int> collection{1, 2, 3, 4, 5, 6, 7};
+  int second_filter_calls = 0;
+  auto filtered = Filter(collection, is_odd).filter([&second_filter_calls](int value) {
+    second_filter_calls++;
+    return value > 2;
+  });
+
+  EXPECT_THAT(filtered, ElementsAre(3, 5, 7));
+  EXPECT_THAT(Reverse(filtered), ElementsAre(7, 5, 3));
+  // The second filter is only checked for the values that pass the first one
+  second_filter_calls = 0;
+  ForEach(filtered, [](int) {});
+  EXPECT_EQ(4, second_filter_calls);
+  static_assert(is_filtered_over<decltype(filtered), BiDirectionalCollection<int>&>::value, "Filters must be merged");
+}
+
 TEST(FilterReverseTest, ReturnsCorrectValues) {
   BiDirectionalCollection<int> collection{1, 2, 3, 4, 5};
   auto iterator = Reverse(Filter(collection, is_odd));
@@ -1097,6 +1949,203 @@ TEST(FilterReverseTest, FilterRvalueCollection) {
   EXPECT_TYPE(int, decltype(iterator)::value_type);
 }
 
+TEST(FilterTest, MapsEachElementOnce) {
+  BiDirectionalCollection<int> collection{1, 2, 3, 4, 5};
+  int calls = 0;
+  auto mapped = Map(collection, [&calls](int value) {
+    calls++;
+    return ToString(value);
+  });
+  auto iterator = Filter(mapped, [](const string& value) { return value != "2"; });
+
+  vector<string> values{};
+  for (auto it = iterator.begin(); it != iterator.end(); ++it) {
+    values.push_back(*it);
+    EXPECT_EQ(values.back(), *it);
+    EXPECT_EQ(1u, it->size());
+  }
+  EXPECT_THAT(values, ElementsAre("1", "3", "4", "5"));
+  EXPECT_EQ(5, calls);
+
+  calls = 0;
+  EXPECT_THAT(Reverse(iterator), ElementsAre("5", "4", "3", "1"));
+  EXPECT_EQ(5, calls);
+}
+
+TEST(FilterTest, OverMoveOnlyMappedValues) {
+  vector<int> collection{1, 2, 3};
+  auto iterator = Filter(Map(collection, [](int value) { return std::make_unique<int>(value); }),
+                         [](const std::unique_ptr<int>& value) { return *value != 2; });
+
+  vector<int> values{};
+  for (const auto& value : iterator)
+    values.push_back(*value);
+  EXPECT_THAT(values, ElementsAre(1, 3));
+}
+
+TEST(FilterMapTest, ReturnsPresentValues) {
+  vector<string> lines{"1", "x", "3", "", "5"};
+  int calls = 0;
+  auto parse = [&calls](const string& line) -> std::optional<int> {
+    calls++;
+    if (line.empty() || !std::isdigit(line[0]))
+      return std::nullopt;
+    return std::stoi(line);
+  };
+  auto iterator = FilterMap(lines, parse);
+
+  EXPECT_TYPE(int, decltype(iterator)::value_type);
+  EXPECT_THAT(iterator, ElementsAre(1, 3, 5));
+  EXPECT_EQ(5, calls);
+  EXPECT_THAT(Reverse(iterator), ElementsAre(5, 3, 1));
+  EXPECT_EQ(9, Iterate(lines).filter_map(parse).sum());
+}
+
+TEST(FilterMapTest, MovesValuesOutOfOptionals) {
+  ForwardOnlyCollection<int> collection{1, 2, 3};
+  auto iterator = FilterMap(collection, [](int value) -> std::optional<std::unique_ptr<int>> {
+    if (value == 2)
+      return std::nullopt;
+    return std::make_unique<int>(value);
+  });
+
+  vector<int> values{};
+  for (std::unique_ptr<int> value : iterator)
+    values.push_back(*value);
+  EXPECT_THAT(values, ElementsAre(1, 3));
+}
+
+TEST(CacheTest, ComputesEachElementOnce) {
+  BiDirectionalCollection<int> collection{1, 2, 3};
+  int calls = 0;
+  auto cached = Map(collection, [&calls](int value) {
+    calls++;
+    return ToString(value);
+  }).cache();
+
+  EXPECT_EQ(3u, cached.size());
+  EXPECT_THAT(cached, ElementsAre("1", "2", "3"));
+  EXPECT_THAT(Reverse(cached), ElementsAre("3", "2", "1"));
+  EXPECT_THAT(cached.filter([](const string& value) { return value != "2"; }), ElementsAre("1", "3"));
+  EXPECT_EQ(3, calls);
+  TEST_CONST_ITERATOR(cached, const string&);
+  EXPECT_TYPE(string, decltype(cached)::value_type);
+}
+
+TEST(CacheTest, ComputesOnlyIteratedElements) {
+  ForwardOnlyCollection<int> collection{1, 2, 3, 4};
+  int calls = 0;
+  auto cached = Cache(Map(collection, [&calls](int value) {
+    calls++;
+    return value * 10;
+  }));
+
+  EXPECT_EQ(0, calls);
+  EXPECT_FALSE(cached.IsEmpty());
+  auto it = cached.begin();
+  EXPECT_EQ(10, *it);
+  EXPECT_EQ(20, *++it);
+  EXPECT_EQ(2, calls);
+  EXPECT_EQ(40, *--cached.end());
+  EXPECT_EQ(4, calls);
+  EXPECT_TRUE(Cache(vector<int>{}).empty());
+}
+
+TEST(CacheTest, ReturnsStableReferences) {
+  vector<int> collection(1000);
+  std::iota(collection.begin(), collection.end(), 0);
+  auto cached = Cache(Map(collection, [](int value) { return ToString(value); }));
+  const string* first = &*cached.begin();
+
+  EXPECT_EQ(1000u, cached.size());
+  EXPECT_EQ(first, &*cached.begin());
+  auto moved = std::move(cached);
+  EXPECT_EQ(first, &*moved.begin());
+  EXPECT_EQ("999", *moved.rbegin());
+}
+
+TEST(CacheBeginTest, RemembersBeginAndSize) {
+  vector<int> collection{1, 3, 5, 7, 8, 9, 10};
+  int calls = 0;
+  const auto iterator = Filter(collection, [&calls](int value) {
+    calls++;
+    return value % 2 == 0;
+  }).cache_begin();
+
+  EXPECT_FALSE(iterator.empty());
+  EXPECT_EQ(5, calls);
+  EXPECT_EQ(8, *iterator.begin());
+  EXPECT_EQ(5, calls);
+  EXPECT_EQ(2u, iterator.size());
+  calls = 0;
+  EXPECT_EQ(2u, iterator.Size());
+  EXPECT_THAT(iterator, ElementsAre(8, 10));
+  EXPECT_EQ(2, calls);
+  TEST_CONST_ITERATOR(iterator, const int&);
+}
+
+TEST(CacheBeginTest, OverChain) {
+  vector<vector<int>> collection{{}, {}, {1, 2}, {}, {3}};
+  const auto iterator = CacheBegin(Chain(collection));
+
+  EXPECT_FALSE(iterator.IsEmpty());
+  EXPECT_EQ(3u, iterator.size());
+  EXPECT_THAT(iterator, ElementsAre(1, 2, 3));
+  EXPECT_TRUE(CacheBegin(Chain(vector<vector<int>>{{}, {}})).empty());
+}
+
+// Counts how often it is asked for its size
+struct CountingSizeCollection : vector<int> {
+  using vector<int>::vector;
+
+  std::size_t size() const {
+    size_calls++;
+    return vector<int>::size();
+  }
+
+  mutable int size_calls = 0;
+};
+
+TEST(CacheBeginTest, AsksNestedCollectionForItsSize) {
+  CountingSizeCollection collection{1, 2, 3};
+  const auto iterator = CacheBegin(collection);
+
+  EXPECT_EQ(3u, iterator.size());
+  EXPECT_EQ(3u, iterator.Size());
+  EXPECT_EQ(1, collection.size_calls);
+  EXPECT_EQ(3u, Chain(vector<vector<int>>{{1, 2}, {}, {3}}).cache_begin().size());
+}
+
+TEST(CacheBeginTest, AssignedViewsFindBeginAgain) {
+  vector<vector<int>> first{{}, {1, 2}};
+  vector<vector<int>> second{{3}, {}, {4}};
+  auto iterator = CacheBegin(Chain(first));
+  const auto other = CacheBegin(Chain(second));
+  EXPECT_EQ(1, *iterator.begin());
+  EXPECT_EQ(3, *other.begin());
+
+  iterator = other;
+  EXPECT_EQ(3, *iterator.begin());
+  EXPECT_EQ(2u, iterator.size());
+  iterator = CacheBegin(Chain(first));
+  EXPECT_THAT(iterator, ElementsAre(1, 2));
+  EXPECT_EQ(2u, iterator.size());
+}
+
+TEST(CacheBeginTest, CopiesFindBeginAgain) {
+  vector<int> collection{1, 2, 3, 4};
+  auto iterator = Filter(collection, [](int value) { return value > 2; }).cache_begin();
+  EXPECT_EQ(3, *iterator.begin());
+
+  auto copy = iterator;
+  auto moved = std::move(iterator);
+  EXPECT_THAT(copy, ElementsAre(3, 4));
+  EXPECT_THAT(moved, ElementsAre(3, 4));
+  vector<int> values;
+  ForEach(moved, [&values](int value) { values.push_back(value); });
+  EXPECT_THAT(values, ElementsAre(3, 4));
+}
+
 ForwardOnlyCollection<std::unique_ptr<int>> ToUniquePtrForwardOnlyCollection(int* values, int values_size) {
   ForwardOnlyCollection<std::unique_ptr<int>> result{};
   for (int i = values_size - 1; i >= 0; i--)
@@ -1196,6 +2245,18 @@ TEST(AsReferencesTest_unique_ptr, CanChainOperators) {
   TEST_BIDIRECTIONAL_CHAINED_OPERATORS(bidirectional_iterator);
 }
 
+TEST(AsReferencesTest_unique_ptr, SupportsRandomAccess) {
+  int values[] = {1, 3, 5};
+  auto collection = ToUniquePtrBidirectionalCollection(values, 3);
+  auto iterator = AsReferences(collection);
+
+  EXPECT_TYPE(std::random_access_iterator_tag, std::iterator_traits<decltype(iterator.begin())>::iterator_category);
+  EXPECT_EQ(3, iterator.end() - iterator.begin());
+  EXPECT_EQ(5, iterator.begin()[2]);
+  EXPECT_EQ(&*collection[1], &*(iterator.end() - 2));
+  EXPECT_EQ(1, std::lower_bound(iterator.begin(), iterator.end(), 3) - iterator.begin());
+}
+
 TEST(AsReferencesReverseTest_unique_ptr, ReturnsCorrectValues) {
   int values[] = {1, 3, 5};
   auto collection{ToUniquePtrBidirectionalCollection(values, 3)};
@@ -1346,6 +2407,17 @@ TEST(AsReferencesTest_pointer, CanChainOperators) {
   TEST_BIDIRECTIONAL_CHAINED_OPERATORS(bidirectional_iterator);
 }
 
+TEST(AsReferencesTest_pointer, SupportsRandomAccess) {
+  int values[] = {1, 3, 5};
+  BiDirectionalCollection<int*> collection{&values[0], &values[1], &values[2]};
+  auto iterator = AsReferences(collection);
+
+  EXPECT_TYPE(std::random_access_iterator_tag, std::iterator_traits<decltype(iterator.begin())>::iterator_category);
+  EXPECT_EQ(3, iterator.end() - iterator.begin());
+  EXPECT_EQ(&values[2], &iterator.begin()[2]);
+  EXPECT_EQ(2, std::lower_bound(iterator.begin(), iterator.end(), 5) - iterator.begin());
+}
+
 TEST(AsReferencesReverseTest_pointer, ReturnsCorrectValues) {
   int values[] = {1, 3, 5};
   auto collection{ToPointerBidirectionalCollection(values, 3)};
@@ -1431,6 +2503,19 @@ TEST(ChainTest, SupportsEmpty) {
   EXPECT_FALSE(Chain(non_empty).empty());
 }
 
+TEST(ChainTest, SeesChangesToNestedCollections) {
+  vector<vector<int>> collection{{}, {1}};
+  const auto iterator = Chain(collection);
+
+  EXPECT_EQ(1u, iterator.size());
+  collection[0].push_back(0);
+  EXPECT_EQ(2u, iterator.size());
+  EXPECT_THAT(iterator, ElementsAre(0, 1));
+  collection.resize(1);
+  collection[0].clear();
+  EXPECT_TRUE(iterator.empty());
+}
+
 TEST(ChainTest, CanModifyValues) {
   ForwardOnlyCollection<list<int>> collection{{1, 2, 3}, {4, 5, 6}};
   auto iterator = Chain(collection);
@@ -1548,6 +2633,85 @@ TEST(ChainReverseTest, ChainRvalueCollection) {
   EXPECT_TYPE(int, decltype(iterator)::value_type);
 }
 
+TEST(IndexedChainTest, ReturnsCorrectValues) {
+  vector<vector<int>> collection{{}, {1, 2}, {}, {}, {3}, {4, 5, 6}, {}};
+  const auto iterator = IndexedChain(collection);
+
+  EXPECT_THAT(iterator, ElementsAre(1, 2, 3, 4, 5, 6));
+  EXPECT_THAT(Reverse(iterator), ElementsAre(6, 5, 4, 3, 2, 1));
+  EXPECT_EQ(6, iterator.size());
+  EXPECT_FALSE(iterator.IsEmpty());
+  EXPECT_TRUE(IndexedChain(vector<vector<int>>{{}, {}}).empty());
+  EXPECT_TRUE(IndexedChain(vector<vector<int>>{}).empty());
+}
+
+TEST(IndexedChainTest, SupportsRandomAccess) {
+  vector<vector<int>> collection{{1, 2}, {}, {3}, {4, 5, 6}, {}, {7}};
+  const auto iterator = IndexedChain(collection);
+  using _iterator = decltype(iterator.begin());
+
+  EXPECT_TYPE(std::random_access_iterator_tag, std::iterator_traits<_iterator>::iterator_category);
+  EXPECT_EQ(4, iterator[3]);
+  EXPECT_EQ(7, iterator[6]);
+  EXPECT_EQ(6, *(iterator.begin() + 5));
+  EXPECT_EQ(3, iterator.begin()[2]);
+  EXPECT_EQ(7, iterator.end() - iterator.begin());
+  EXPECT_EQ(5, *(iterator.end() - 3));
+  EXPECT_EQ(3, *std::prev(iterator.begin() + 3));
+  EXPECT_EQ(2, *std::prev(iterator.begin() + 2));
+  EXPECT_TRUE(iterator.begin() + 2 < iterator.begin() + 3);
+  EXPECT_EQ(4, std::lower_bound(iterator.begin(), iterator.end(), 5) - iterator.begin());
+  EXPECT_EQ(iterator.end(), std::lower_bound(iterator.begin(), iterator.end(), 8));
+}
+
+TEST(IndexedChainTest, CanModifyValues) {
+  vector<vector<int>> collection{{3, 1}, {}, {2}};
+  auto iterator = IndexedChain(collection);
+
+  iterator[2] = 4;
+  std::sort(iterator.begin(), iterator.end());
+  EXPECT_THAT(collection, ElementsAre(ElementsAre(1, 3), ElementsAre(), ElementsAre(4)));
+}
+
+TEST(IndexedChainTest, OverNonConstCollection) {
+  vector<vector<int>> collection{{1, 2, 3}, {4, 5, 6}};
+  auto iterator = IndexedChain(collection);
+
+  TEST_NON_CONST_ITERATOR(iterator, int&);
+  TEST_CONST_ITERATOR(iterator, int const&);
+  TEST_NON_CONST_REVERSE_ITERATOR(iterator, int&);
+  TEST_CONST_REVERSE_ITERATOR(iterator, int const&);
+  EXPECT_TYPE(int, decltype(iterator)::value_type);
+}
+
+TEST(IndexedChainTest, OverConstCollection) {
+  const vector<vector<int>> collection{{1, 2, 3}, {4, 5, 6}};
+  auto iterator = IndexedChain(collection);
+
+  TEST_NON_CONST_ITERATOR(iterator, int const&);
+  TEST_CONST_ITERATOR(iterator, int const&);
+  EXPECT_TYPE(int, decltype(iterator)::value_type);
+}
+
+TEST(IndexedChainTest, IndexedChainRvalueCollection) {
+  auto iterator = IndexedChain(vector<vector<int>>{{1, 2, 3}, {}, {4}});
+  auto moved = std::move(iterator);
+
+  TEST_NON_CONST_ITERATOR(moved, int&);
+  EXPECT_THAT(moved, ElementsAre(1, 2, 3, 4));
+  EXPECT_EQ(4, moved[3]);
+}
+
+TEST(IndexedChainTest, IsSplitByElement) {
+  vector<vector<int>> collection{{1, 2}, {3, 4, 5}, {6}};
+  auto iterator = IndexedChain(collection);
+
+  EXPECT_EQ(6, details::SplitSize(iterator));
+  auto halves = details::SplitAt(iterator, 3);
+  EXPECT_THAT(halves.first, ElementsAre(1, 2, 3));
+  EXPECT_THAT(halves.second, ElementsAre(4, 5, 6));
+}
+
 template <typename _Zipped> string FormatZip(const _Zipped& iterable) {
   string result{};
   for (const auto& item : iterable)
@@ -1692,6 +2856,32 @@ TEST(ZipTest, CanChainOperators) {
   TEST_BIDIRECTIONAL_CHAINED_OPERATORS(bidirectional_iterator);
 }
 
+TEST(ZipTest, SupportsRandomAccess) {
+  BiDirectionalCollection<int> first{1, 2, 3, 4};
+  BiDirectionalCollection<char> second{'A', 'B', 'C'};
+  auto iterator = Zip(first, second);
+  auto begin = iterator.begin();
+
+  EXPECT_TYPE(std::random_access_iterator_tag, std::iterator_traits<decltype(begin)>::iterator_category);
+  // The distance to 'end' is limited by the shortest collection
+  EXPECT_EQ(3, iterator.end() - begin);
+  EXPECT_EQ(-3, begin - iterator.end());
+  EXPECT_EQ(3, begin[2].First());
+  EXPECT_EQ('C', begin[2].Second());
+  EXPECT_TRUE(begin + 3 == iterator.end());
+  EXPECT_FALSE(begin + 1 == begin + 2);
+
+  auto found = std::lower_bound(iterator.begin(), iterator.end(), 'B',
+                                [](const auto& value, char key) { return value.Second() < key; });
+  EXPECT_EQ(1, found - begin);
+}
+
+TEST(ZipTest, ZipWithForwardOnlyCollectionIsNotRandomAccess) {
+  auto iterator = Zip(BiDirectionalCollection<int>{}, ForwardOnlyCollection<int>{});
+
+  EXPECT_TYPE(std::forward_iterator_tag, std::iterator_traits<decltype(iterator.begin())>::iterator_category);
+}
+
 TEST(ZipReverseTest, ReturnsCorrectValues) {
   BiDirectionalCollection<int> first{1, 2, 3};
   OtherBiDirectionalCollection<char> second{'A', 'B', 'C'};
@@ -0,0 +1,166 @@
+#pragma once
+
+#ifndef _CPP_ITERATORS_LINES_H_
+#define _CPP_ITERATORS_LINES_H_
+
+#include "iterators.h"
+#include "mapped_file.h"
+
+// Lines are returned as std::string_view (C++17), read through POSIX memory mappings
+#if __cplusplus >= 201703L && (defined(__unix__) || defined(__APPLE__))
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace iterators {
+
+class FileLines;
+
+// Returns the lines of a text file as std::string_views (without their '\n'), without copying them.
+//
+// Regular files are mapped into memory, so the lines point straight into the mapping, and stay valid for as long
+// as the returned collection exists. Those can be iterated several times.
+// All other files (like pipes or '/dev/stdin') are read a block at a time, so a line only stays valid until the
+// iterator moves to the next one, and the lines can only be iterated once.
+// Throws std::system_error if the file can not be opened or read.
+//
+// Simply write this:
+//
+// for (std::string_view error : Lines("/var/log/server.log").filter(is_error))
+//   Report(error);
+FileLines Lines(const std::string& path);
+
+//-----------------------------------------------------------------------------
+// Implementation
+//-----------------------------------------------------------------------------
+
+// Returned by 'Lines'
+class FileLines : public WithChainedOperators<FileLines> {
+ public:
+  class const_iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view*;
+    using reference = const std::string_view&;
+
+    // The end of every iteration
+    const_iterator() = default;
+    const_iterator(const FileLines* lines, std::string_view line) : lines_(lines), line_(line) {}
+
+    reference operator*() const { return line_; }
+    pointer operator->() const { return &line_; }
+
+    const_iterator& operator++() {
+      line_ = lines_->NextLine(line_);
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator result = *this;
+      ++*this;
+      return result;
+    }
+
+    // The end has no data (while an empty line points to its position in the file)
+    bool operator==(const const_iterator& other) const { return line_.data() == other.line_.data(); }
+    bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+   private:
+    const FileLines* lines_ = nullptr;
+    std::string_view line_{};
+  };
+  using iterator = const_iterator;
+  using value_type = std::string_view;
+
+  explicit FileLines(const std::string& path) : file_(path, false, MADV_SEQUENTIAL, "Lines") {}
+
+  // True if the file is mapped into memory (see 'Lines'), false if it is read a block at a time
+  bool IsMapped() const { return file_.IsMapped(); }
+
+  const_iterator begin() const { return const_iterator{this, FirstLine()}; }
+  const_iterator end() const { return const_iterator{}; }
+
+ private:
+  // Blocks are read in chunks of at least this many bytes when the file is not mapped
+  static constexpr std::size_t kReadSize = 64 * 1024;
+
+  std::string_view FirstLine() const {
+    if (!IsMapped())
+      return ReadLine();
+    return file_.size() == 0 ? std::string_view{} : LineAt(file_.data());
+  }
+
+  std::string_view NextLine(std::string_view line) const {
+    if (!IsMapped())
+      return ReadLine();
+    // Skips the '\n' at the end of 'line' (which is past the end of the mapping for the last line)
+    const char* next = line.data() + line.size() + 1;
+    return next >= file_.data() + file_.size() ? std::string_view{} : LineAt(next);
+  }
+
+  // The line starting at 'begin' in the mapping. memchr scans a vector register at a time.
+  std::string_view LineAt(const char* begin) const {
+    const std::size_t remaining = static_cast<std::size_t>(file_.data() + file_.size() - begin);
+    const auto* newline = static_cast<const char*>(std::memchr(begin, '\n', remaining));
+    return {begin, newline == nullptr ? remaining : static_cast<std::size_t>(newline - begin)};
+  }
+
+  // Returns the next line from the buffer, which it refills as needed (or no data at the end of the file)
+  std::string_view ReadLine() const;
+
+  details::MappedFile file_;
+  // Only used if the file is not mapped. Iterating a const collection reads it, hence 'mutable'.
+  mutable std::vector<char> buffer_{};
+  mutable std::size_t position_ = 0;  // The first byte in 'buffer_' that has not been returned yet
+  mutable std::size_t filled_ = 0;    // The number of bytes read into 'buffer_'
+  mutable bool end_of_file_ = false;
+};
+
+inline std::string_view FileLines::ReadLine() const {
+  while (true) {
+    const char* begin = buffer_.data() + position_;
+    // The empty buffer has no data, which memchr and memmove must not be given (even for 0 bytes)
+    const void* newline = filled_ == position_ ? nullptr : std::memchr(begin, '\n', filled_ - position_);
+    if (newline) {
+      const std::size_t size = static_cast<std::size_t>(static_cast<const char*>(newline) - begin);
+      position_ += size + 1;
+      return {begin, size};
+    }
+    if (end_of_file_) {
+      // The last line, if the file does not end with a '\n'
+      const std::size_t size = filled_ - position_;
+      position_ = filled_;
+      return size == 0 ? std::string_view{} : std::string_view{begin, size};
+    }
+    // Moves the start of the line to the front, and makes room for another block after it
+    filled_ -= position_;
+    if (filled_ > 0)
+      std::memmove(buffer_.data(), begin, filled_);
+    position_ = 0;
+    if (buffer_.size() < filled_ + kReadSize)
+      buffer_.resize(std::max(2 * buffer_.size(), filled_ + kReadSize));
+    const ssize_t read_size = read(file_.Descriptor(), buffer_.data() + filled_, buffer_.size() - filled_);
+    if (read_size < 0 && errno != EINTR)
+      throw std::system_error(errno, std::generic_category(), "Lines: can not read");
+    if (read_size == 0)
+      end_of_file_ = true;
+    filled_ += read_size > 0 ? static_cast<std::size_t>(read_size) : 0;
+  }
+}
+
+inline FileLines Lines(const std::string& path) { return FileLines{path}; }
+
+}  // namespace iterators
+
+#endif  // __cplusplus >= 201703L
+
+#endif  // _CPP_ITERATORS_LINES_H_
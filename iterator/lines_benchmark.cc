@@ -0,0 +1,51 @@
+
+#include "lines.h"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "benchmark/benchmark.h"
+
+#if __cplusplus >= 201703L && (defined(__unix__) || defined(__APPLE__))
+namespace iterators {
+namespace {
+
+// A log of about 16 MB, with lines of varying lengths (some of them empty)
+const std::string& LogFile() {
+  static const std::string path = []() {
+    const std::string result = "/tmp/lines_benchmark.log";
+    std::FILE* file = std::fopen(result.c_str(), "wb");
+    for (int line = 0; line < 200000; line++)
+      std::fprintf(file, "%s\n", std::string(line % 157, static_cast<char>('a' + line % 26)).c_str());
+    std::fclose(file);
+    return result;
+  }();
+  return path;
+}
+
+void BM_NonEmptyLines_Getline(benchmark::State& state) {
+  for (auto _ : state) {
+    std::ifstream input(LogFile());
+    std::size_t count = 0;
+    for (std::string line; std::getline(input, line);)
+      count += !line.empty();
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * 200000);
+}
+BENCHMARK(BM_NonEmptyLines_Getline);
+
+void BM_NonEmptyLines_Lines(benchmark::State& state) {
+  for (auto _ : state) {
+    const std::size_t count = Lines(LogFile()).filter([](std::string_view line) { return !line.empty(); }).count();
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * 200000);
+}
+BENCHMARK(BM_NonEmptyLines_Lines);
+
+}  // namespace
+}  // namespace iterators
+#endif  // __cplusplus >= 201703L
+
+BENCHMARK_MAIN();
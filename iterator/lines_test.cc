@@ -0,0 +1,101 @@
+
+#include "lines.h"
+#include <cstdio>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#if __cplusplus >= 201703L && (defined(__unix__) || defined(__APPLE__))
+namespace iterators {
+using std::string;
+using std::string_view;
+using std::vector;
+using testing::ElementsAre;
+
+string WriteFile(const string& name, const string& content) {
+  const string path = testing::TempDir() + "/" + name;
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  std::fwrite(content.data(), 1, content.size(), file);
+  std::fclose(file);
+  return path;
+}
+
+vector<string> ToStrings(const FileLines& lines) {
+  vector<string> result{};
+  for (string_view line : lines)
+    result.emplace_back(line);
+  return result;
+}
+
+// Writes 'content' into a pipe from another thread, and reads it through '/dev/fd'
+vector<string> ReadThroughPipe(const string& content) {
+  int pipe_ends[2];
+  EXPECT_EQ(0, pipe(pipe_ends));
+  std::thread writer([&content, &pipe_ends]() {
+    for (std::size_t written = 0; written < content.size();)
+      written += static_cast<std::size_t>(write(pipe_ends[1], content.data() + written, content.size() - written));
+    close(pipe_ends[1]);
+  });
+  auto lines = Lines("/dev/fd/" + std::to_string(pipe_ends[0]));
+  close(pipe_ends[0]);
+  EXPECT_FALSE(lines.IsMapped());
+  vector<string> result = ToStrings(lines);
+  writer.join();
+  return result;
+}
+
+TEST(LinesTest, SplitsMappedFile) {
+  auto lines = Lines(WriteFile("lines", "first\n\nthird\r\nlast"));
+  EXPECT_TRUE(lines.IsMapped());
+  EXPECT_THAT(ToStrings(lines), ElementsAre("first", "", "third\r", "last"));
+  // Can be iterated again
+  EXPECT_THAT(ToStrings(lines), ElementsAre("first", "", "third\r", "last"));
+
+  EXPECT_THAT(ToStrings(Lines(WriteFile("newline_at_end", "first\nsecond\n"))), ElementsAre("first", "second"));
+  EXPECT_THAT(ToStrings(Lines(WriteFile("only_newline", "\n"))), ElementsAre(""));
+  EXPECT_THAT(ToStrings(Lines(WriteFile("empty", ""))), ElementsAre());
+}
+
+TEST(LinesTest, ReturnsViewsIntoMapping) {
+  auto lines = Lines(WriteFile("views", "first\nsecond\n"));
+  auto it = lines.begin();
+  const string_view first = *it;
+  const string_view second = *++it;
+  EXPECT_EQ(first.data() + first.size() + 1, second.data());
+  EXPECT_EQ("first", first);
+  EXPECT_EQ(++it, lines.end());
+}
+
+TEST(LinesTest, ReadsPipe) {
+  EXPECT_THAT(ReadThroughPipe("first\n\nthird\r\nlast"), ElementsAre("first", "", "third\r", "last"));
+  EXPECT_THAT(ReadThroughPipe("first\n"), ElementsAre("first"));
+  EXPECT_THAT(ReadThroughPipe(""), ElementsAre());
+
+  // Lines larger than a block
+  const string long_line(200000, 'x');
+  EXPECT_THAT(ReadThroughPipe(long_line + "\nshort\n" + long_line), ElementsAre(long_line, "short", long_line));
+}
+
+TEST(LinesTest, ChainsWithOtherOperators) {
+  auto lines = Lines(WriteFile("chained", "apple\n\nbanana\ncherry\n"));
+  auto not_empty = [](string_view line) { return !line.empty(); };
+  auto size_of = [](string_view line) { return line.size(); };
+
+  EXPECT_EQ(3, Count(Filter(lines, not_empty)));
+  EXPECT_EQ(17, Sum(Map(lines, size_of)));
+  EXPECT_EQ(17, Lines(WriteFile("chained", "apple\n\nbanana\ncherry\n")).map(size_of).sum());
+  vector<std::pair<int, string>> items{};
+  for (const auto& item : Lines(WriteFile("enumerated", "a\nb\n")).enumerate())
+    items.emplace_back(item.Position(), item.Value());
+  EXPECT_THAT(items, ElementsAre(std::make_pair(0, "a"), std::make_pair(1, "b")));
+}
+
+TEST(LinesTest, ThrowsIfFileIsMissing) {
+  EXPECT_THROW(Lines(testing::TempDir() + "/missing"), std::system_error);
+}
+
+}  // namespace iterators
+#endif  // __cplusplus >= 201703L
@@ -0,0 +1,154 @@
+#pragma once
+
+#ifndef _CPP_ITERATORS_MAPPED_FILE_H_
+#define _CPP_ITERATORS_MAPPED_FILE_H_
+
+#include "iterators.h"
+
+// Files are mapped into memory through POSIX
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace iterators {
+
+// A file of fixed-size records (e.g. telemetry written as an array of POD structs), mapped into memory as a
+// random-access collection of 'const T&' (without reading or copying anything).
+//
+// Opening it costs the same for every file size, and the pages are only read once they are accessed.
+// Like a vector, it supports 'size', 'data', indexing and reverse iterating, so Enumerate, Zip, Reverse, Filter, ...
+// work directly on the data in the file. A partial record at the end of the file (e.g. one that is being appended)
+// is ignored.
+// Throws std::system_error if the file can not be opened, or can not be mapped (e.g. a pipe).
+//
+// Simply write this:
+//
+// MappedRecords<Sample> samples("/data/samples.bin");
+// for (const auto& item : samples.enumerate().filter(is_anomaly))
+//   Report(item.Position(), item.Value());
+template <typename T> class MappedRecords;
+
+//-----------------------------------------------------------------------------
+// Implementation
+//-----------------------------------------------------------------------------
+
+namespace details {
+
+// Owns an open file, which it maps into memory (read-only) if that file is a regular file that is not empty.
+// If 'must_map', any other file is an error, otherwise it is simply kept open (see 'Descriptor').
+class MappedFile {
+ public:
+  // 'advice' is passed to 'madvise' (e.g. MADV_SEQUENTIAL), 'caller' is mentioned in errors
+  MappedFile(const std::string& path, bool must_map, int advice, const char* caller) {
+    descriptor_ = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor_ < 0)
+      throw std::system_error(errno, std::generic_category(), std::string(caller) + ": can not open " + path);
+    struct stat status {};
+    if (fstat(descriptor_, &status) != 0 || !S_ISREG(status.st_mode)) {
+      if (must_map)
+        Fail(ENODEV, caller, path);
+      return;
+    }
+    // Special regular files can claim to be empty (like in /proc), so those are only closed if they must be mapped
+    if (status.st_size == 0) {
+      if (must_map)
+        Close();
+      return;
+    }
+    void* data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor_, 0);
+    if (data == MAP_FAILED) {
+      if (must_map)
+        Fail(errno, caller, path);
+      return;
+    }
+    madvise(data, static_cast<std::size_t>(status.st_size), advice);
+    data_ = static_cast<const char*>(data);
+    size_ = static_cast<std::size_t>(status.st_size);
+    Close();
+  }
+  MappedFile(MappedFile&& other) noexcept
+      : descriptor_(std::exchange(other.descriptor_, -1)),
+        data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile() {
+    if (data_ != nullptr)
+      munmap(const_cast<char*>(data_), size_);
+    Close();
+  }
+
+  // False if the file is kept open instead
+  bool IsMapped() const { return descriptor_ < 0; }
+  // The file, only if it is not mapped
+  int Descriptor() const { return descriptor_; }
+
+  // The mapping (which is empty if the file is not mapped)
+  const char* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+ private:
+  void Close() {
+    if (descriptor_ >= 0)
+      close(std::exchange(descriptor_, -1));
+  }
+  void Fail(int error, const char* caller, const std::string& path) {
+    Close();
+    throw std::system_error(error, std::generic_category(), std::string(caller) + ": can not map " + path);
+  }
+
+  int descriptor_ = -1;
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+}  // namespace details
+
+template <typename T> class MappedRecords : public WithChainedOperators<MappedRecords<T>> {
+  static_assert(std::is_trivially_copyable<T>::value, "The records are the bytes of the file");
+
+ public:
+  using value_type = T;
+  using const_iterator = const T*;
+  using iterator = const_iterator;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using reverse_iterator = const_reverse_iterator;
+
+  // Pages of files are page-aligned, so the records are aligned too
+  explicit MappedRecords(const std::string& path) : file_(path, true, MADV_NORMAL, "MappedRecords") {}
+
+  const T* data() const { return reinterpret_cast<const T*>(file_.data()); }
+  const T& operator[](std::size_t position) const { return data()[position]; }
+
+  const_iterator begin() const { return data(); }
+  const_iterator end() const { return data() + size(); }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator{end()}; }
+  const_reverse_iterator rend() const { return const_reverse_iterator{begin()}; }
+
+  // STL-container compliant method to get the number of records
+  std::size_t size() const { return file_.size() / sizeof(T); }
+  // Code style compliant method to get the number of records
+  std::size_t Size() const { return size(); }
+  // STL-container compliant method to check if there are no records
+  bool empty() const { return size() == 0; }
+  // Code style compliant method to check if there are no records
+  bool IsEmpty() const { return empty(); }
+
+ private:
+  details::MappedFile file_;
+};
+
+}  // namespace iterators
+
+#endif  // defined(__unix__) || defined(__APPLE__)
+
+#endif  // _CPP_ITERATORS_MAPPED_FILE_H_
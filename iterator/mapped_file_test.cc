@@ -0,0 +1,86 @@
+
+#include "mapped_file.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+namespace iterators {
+using std::string;
+using std::vector;
+using testing::ElementsAre;
+
+struct Sample {
+  std::int64_t time;
+  double value;
+};
+
+string WriteRecords(const string& name, const vector<Sample>& samples, std::size_t extra_bytes = 0) {
+  const string path = testing::TempDir() + "/" + name;
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  // The data of an empty vector may be null, which fwrite does not accept
+  if (!samples.empty())
+    std::fwrite(samples.data(), sizeof(Sample), samples.size(), file);
+  for (std::size_t i = 0; i < extra_bytes; i++)
+    std::fputc(0, file);
+  std::fclose(file);
+  return path;
+}
+
+template <typename T> vector<typename T::value_type> ToVector(T&& collection) {
+  vector<typename T::value_type> result{};
+  for (auto&& value : collection)
+    result.push_back(value);
+  return result;
+}
+
+auto time_of = [](const Sample& sample) { return sample.time; };
+
+TEST(MappedRecordsTest, MapsRecordsOfFile) {
+  const MappedRecords<Sample> samples(WriteRecords("samples", {{1, 0.5}, {2, 1.5}, {3, 2.5}}));
+  EXPECT_EQ(3, samples.size());
+  EXPECT_FALSE(samples.IsEmpty());
+  EXPECT_EQ(2, samples[1].time);
+  EXPECT_EQ(2.5, samples.data()[2].value);
+  EXPECT_THAT(ToVector(Map(samples, time_of)), ElementsAre(1, 2, 3));
+  EXPECT_EQ(3, std::distance(samples.begin(), samples.end()));
+
+  // A partial record at the end is ignored
+  EXPECT_EQ(2, MappedRecords<Sample>(WriteRecords("partial", {{1, 0.5}, {2, 1.5}}, 5)).size());
+  EXPECT_TRUE(MappedRecords<Sample>(WriteRecords("empty", {})).empty());
+}
+
+TEST(MappedRecordsTest, WorksWithOtherOperators) {
+  const MappedRecords<Sample> samples(WriteRecords("operators", {{1, 0.5}, {2, 1.5}, {3, 2.5}}));
+  const vector<string> names{"a", "b", "c"};
+
+  EXPECT_THAT(ToVector(Map(Reverse(samples), time_of)), ElementsAre(3, 2, 1));
+  EXPECT_THAT(ToVector(Map(Filter(samples, [](const Sample& sample) { return sample.value > 1; }), time_of)),
+              ElementsAre(2, 3));
+  vector<std::pair<int, std::int64_t>> items{};
+  for (const auto& item : Enumerate(samples))
+    items.emplace_back(item.Position(), item.Value().time);
+  EXPECT_THAT(items, ElementsAre(std::make_pair(0, 1), std::make_pair(1, 2), std::make_pair(2, 3)));
+  vector<string> zipped{};
+  for (const auto& pair : Zip(samples, names))
+    zipped.push_back(pair.Second() + std::to_string(pair.First().time));
+  EXPECT_THAT(zipped, ElementsAre("a1", "b2", "c3"));
+  EXPECT_EQ(6, MappedRecords<Sample>(WriteRecords("chained", {{1, 0.5}, {2, 1.5}, {3, 2.5}})).map(time_of).sum());
+}
+
+TEST(MappedRecordsTest, ThrowsIfFileCanNotBeMapped) {
+  EXPECT_THROW(MappedRecords<Sample>(testing::TempDir() + "/missing"), std::system_error);
+  int pipe_ends[2];
+  ASSERT_EQ(0, pipe(pipe_ends));
+  EXPECT_THROW(MappedRecords<Sample>("/dev/fd/" + std::to_string(pipe_ends[0])), std::system_error);
+  close(pipe_ends[0]);
+  close(pipe_ends[1]);
+}
+
+}  // namespace iterators
+#endif  // defined(__unix__)
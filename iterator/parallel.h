@@ -0,0 +1,1304 @@
+#pragma once
+
+#ifndef _CPP_ITERATORS_PARALLEL_H_
+#define _CPP_ITERATORS_PARALLEL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "concurrent_queue.h"
+#include "flat_map.h"
+#include "iterators.h"
+
+namespace iterators {
+
+// A pool of threads that splits loops over a range of elements between them.
+//
+// The calling thread takes part in every loop, so a pool with a concurrency of 'n' starts 'n - 1' threads.
+// Every thread starts with its own share of the chunks, and steals half of the remaining chunks of another
+// thread once it runs out, so threads that get cheaper elements don't sit idle.
+//
+// Loops started from inside a loop body (on any pool) simply run on the calling thread.
+class ThreadPool {
+ public:
+  explicit ThreadPool(std::size_t concurrency = std::thread::hardware_concurrency());
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ~ThreadPool();
+
+  // The number of threads that process a loop, including the calling thread
+  std::size_t Concurrency() const { return workers_.size() + 1; }
+
+  // Calls 'body(begin, end)' for consecutive chunks that cover [0, count), and returns once all have been processed.
+  //
+  // The first elements are processed on the calling thread to measure how long an element takes,
+  // which is used to pick chunks that are big enough to hide the scheduling overhead,
+  // yet small enough to balance the work between the threads.
+  // If 'body' throws, the remaining chunks are skipped and the first exception is rethrown.
+  template <typename Body> void ParallelFor(std::size_t count, const Body& body);
+
+ private:
+  class Job;
+
+  void WorkerLoop();
+
+  std::vector<std::thread> workers_;
+  std::mutex job_mutex_;  // Only a single loop runs at a time
+  std::mutex mutex_;      // Guards all members below
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  Job* job_ = nullptr;
+  std::uint64_t generation_ = 0;
+  bool stopping_ = false;
+};
+
+// The pool used by the parallel operations, unless you pass your own.
+// It uses all the cores of the machine.
+ThreadPool& DefaultThreadPool();
+
+// Runs the terminal operations of a collection on all cores.
+// Use 'for_each(function)', 'reduce(identity, function)' or 'collect()' on the returned object,
+// which work like 'ParallelForEach', 'ParallelReduce' and 'ParallelCollect'.
+//
+// Simply write this:
+//
+// auto results = Iterate(inputs).map(expensive_function).parallel().collect();
+template <typename T> auto Parallel(T&& iterable, ThreadPool& pool);
+template <typename T> auto Parallel(T&& iterable) { return Parallel(std::forward<T>(iterable), DefaultThreadPool()); }
+
+// Calls 'function(element)' for every element, spread over all cores.
+// The elements are processed in no particular order, so 'function' must be safe to call from several threads.
+template <typename T, typename Function> void ParallelForEach(T&& iterable, Function function) {
+  Parallel(std::forward<T>(iterable)).for_each(std::move(function));
+}
+
+// Returns 'function(... function(function(identity, element_0), element_1) ..., element_n)', spread over all cores.
+//
+// Every thread reduces its own chunks before the partial results are combined (in order) with 'function',
+// so 'function' must be associative, accept both '(Value, element)' and '(Value, Value)',
+// and 'identity' must not change the result (e.g. 0 for a sum or 1 for a product).
+// The size of the chunks depends on timing, so floating point results can differ slightly from run to run
+// (see 'ParallelDeterministicReduce').
+template <typename T, typename Value, typename Function>
+Value ParallelReduce(T&& iterable, Value identity, Function function) {
+  return Parallel(std::forward<T>(iterable)).reduce(std::move(identity), std::move(function));
+}
+
+// Returns a std::vector with all the elements (in order), computing them on all cores.
+// The elements must be default constructible.
+template <typename T> auto ParallelCollect(T&& iterable) { return Parallel(std::forward<T>(iterable)).collect(); }
+
+// Like 'ParallelReduce', but the elements are always combined in the same order (and so give the same result,
+// even for floating point values), regardless of the number of threads or how the work got spread over them.
+//
+// The elements are reduced in blocks of a fixed size, and the partial results of the blocks are then combined
+// pairwise in a fixed tree shape, which only depends on the number of elements.
+template <typename T, typename Value, typename Function>
+Value ParallelDeterministicReduce(T&& iterable, Value identity, Function function) {
+  return Parallel(std::forward<T>(iterable)).deterministic_reduce(std::move(identity), std::move(function));
+}
+
+// How 'ParallelSum' adds the elements of a block
+enum class Summation {
+  // Simply adds the elements one by one
+  kPlain,
+  // Keeps track of the rounding error of every addition (Kahan-Babuska summation), which is more accurate when adding
+  // many values of different magnitudes, at the cost of a few extra instructions per element.
+  // Note: this does not work when compiling with '-ffast-math', which optimizes the compensation away.
+  kCompensated,
+};
+
+// Returns the sum of all the (arithmetic) elements, spread over all cores.
+// Just like 'ParallelDeterministicReduce', the result does not depend on the number of threads.
+//
+// Simply write this:
+//
+// double total = ParallelSum(Zip(prices, quantities).map(multiply), Summation::kCompensated);
+template <typename T> auto ParallelSum(T&& iterable, Summation summation = Summation::kPlain) {
+  return Parallel(std::forward<T>(iterable)).sum(summation);
+}
+
+// Groups the elements by 'key_function(element)', and reduces the 'value_function(element)' of the elements of every
+// group with 'function', spread over all cores. Returns a 'FlatMap' from every key to the reduced value of its group.
+//
+// Every thread aggregates its elements into its own hash tables, one for every partition of the hashes,
+// and then the tables of every partition are merged in parallel, so the threads never share a table.
+// The values of a group are combined in no particular order, so 'function' must be associative and commutative
+// (e.g. a sum, a minimum or a maximum).
+//
+// Simply write this:
+//
+// auto totals = GroupReduce(Filter(records, is_valid), [](const Record& record) { return record.key; },
+//                           [](const Record& record) { return record.value; }, std::plus<double>{});
+template <typename T, typename KeyFunction, typename ValueFunction, typename Function>
+auto GroupReduce(T&& iterable, KeyFunction key_function, ValueFunction value_function, Function function) {
+  return Parallel(std::forward<T>(iterable))
+      .group_reduce(std::move(key_function), std::move(value_function), std::move(function));
+}
+
+// Maps every element with 'function' like 'Map', but keeps up to 'concurrency' calls in flight on threads of its own,
+// for functions that mostly wait (e.g. on I/O or a remote service) rather than compute.
+// The mapped elements are still returned in order: they wait in a buffer of 2 * 'concurrency' elements until all
+// elements before them have been consumed, and no new calls start while that buffer is full.
+//
+// Every iteration (every call to 'begin()') starts its own threads, which stop once its last iterator is destroyed.
+// 'function' must be safe to call from several threads, and an exception it throws is rethrown when the mapped element
+// is read. The iterators are input iterators, so iterate only once over each 'begin()'.
+//
+// Simply write this:
+//
+// for (const Response& response : Iterate(requests).map_concurrent(send_request, 16))
+//   Handle(response);
+template <typename T, typename Function> auto MapConcurrent(T&& iterable, Function function, std::size_t concurrency);
+
+// Iterates over the collection on a thread of its own, and hands its elements over in batches through a lock-free
+// ring buffer of (about) 'capacity' elements, so everything upstream runs in parallel with everything downstream.
+// The thread waits while the buffer is full, so it never runs more than 'capacity' elements ahead of the reader.
+//
+// Every iteration (every call to 'begin()') starts its own thread, which stops once its last iterator is destroyed.
+// An exception thrown upstream is rethrown downstream, after the elements before it.
+// The iterators are input iterators, so iterate only once over each 'begin()'.
+//
+// Simply write this:
+//
+// for (const Record& record : Lines(file).map(parse).filter(is_valid).async_buffer(4096).map(enrich))
+//   Store(record);
+template <typename T> auto AsyncBuffer(T&& iterable, std::size_t capacity);
+
+//-----------------------------------------------------------------------------
+// Implementation
+//-----------------------------------------------------------------------------
+
+namespace details {
+
+// True if 'T' supports jumping to any element in constant time
+template <typename T>
+using is_random_access_collection =
+    std::is_base_of<std::random_access_iterator_tag, iterator_category_t<decltype(std::begin(std::declval<T&>()))>>;
+
+// True while the current thread runs the body of a parallel loop
+inline bool& InParallelLoop() {
+  static thread_local bool in_parallel_loop = false;
+  return in_parallel_loop;
+}
+
+// Marks the current thread as running a parallel loop for as long as it exists
+class ParallelLoopScope {
+ public:
+  ParallelLoopScope() : previous_(InParallelLoop()) { InParallelLoop() = true; }
+  ~ParallelLoopScope() { InParallelLoop() = previous_; }
+
+ private:
+  bool previous_;
+};
+
+// The range of chunks [begin, end) a thread still has to process, packed in a single word,
+// so the owner (taking chunks from the front) and thieves (taking them from the back) can update it atomically.
+// Padded to a cache line, so threads updating neighbouring ranges don't slow each other down.
+class ChunkRange {
+ public:
+  void Reset(std::uint32_t begin, std::uint32_t end) { range_.store(Pack(begin, end), std::memory_order_relaxed); }
+
+  // Takes the first chunk, returns false if there is none left
+  bool Pop(std::uint32_t& chunk) {
+    std::uint64_t range = range_.load(std::memory_order_relaxed);
+    while (Begin(range) < End(range)) {
+      if (range_.compare_exchange_weak(range, Pack(Begin(range) + 1, End(range)), std::memory_order_acquire)) {
+        chunk = Begin(range);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Takes the back half of the remaining chunks, returns false if there are none left
+  bool Steal(std::uint32_t& begin, std::uint32_t& end) {
+    std::uint64_t range = range_.load(std::memory_order_relaxed);
+    while (Begin(range) < End(range)) {
+      const std::uint32_t middle = Begin(range) + (End(range) - Begin(range)) / 2;
+      if (range_.compare_exchange_weak(range, Pack(Begin(range), middle), std::memory_order_acquire)) {
+        begin = middle;
+        end = End(range);
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  static std::uint64_t Pack(std::uint32_t begin, std::uint32_t end) { return (std::uint64_t{begin} << 32) | end; }
+  static std::uint32_t Begin(std::uint64_t range) { return static_cast<std::uint32_t>(range >> 32); }
+  static std::uint32_t End(std::uint64_t range) { return static_cast<std::uint32_t>(range); }
+
+  std::atomic<std::uint64_t> range_{0};
+  char padding_[64 - sizeof(std::atomic<std::uint64_t>)];
+};
+
+// How long a chunk should take, so the cost of scheduling it does not matter
+constexpr std::chrono::microseconds kTargetChunkTime{50};
+// How long the calling thread measures the cost of the elements before starting the other threads
+constexpr std::chrono::microseconds kMeasureTime{10};
+// The minimal number of chunks per thread, so there is something left to steal
+constexpr std::size_t kChunksPerThread = 4;
+// The number of pieces deterministic reductions split collections in that can't be split by element,
+// which must not depend on the number of threads
+constexpr std::size_t kDeterministicPieces = 64;
+// The maximal number of groups the tables of a thread are sized for up front by 'GroupReduce',
+// as the number of elements is only an upper bound for the number of groups
+constexpr std::size_t kMaxPresizedGroups = 4096;
+// The maximal number of elements 'AsyncBuffer' hands over at once
+constexpr std::size_t kMaxAsyncBatchSize = 256;
+
+}  // namespace details
+
+// A single loop, shared by all threads that process it
+class ThreadPool::Job {
+ public:
+  template <typename Body>
+  Job(const Body& body, std::size_t offset, std::size_t count, std::size_t grain, std::size_t participants)
+      : run_(&Run<Body>),
+        body_(&body),
+        offset_(offset),
+        count_(count),
+        grain_(grain),
+        participants_(participants),
+        ranges_(new details::ChunkRange[participants]) {
+    const std::size_t chunks = (count + grain - 1) / grain;
+    for (std::size_t slot = 0; slot < participants; slot++) {
+      ranges_[slot].Reset(static_cast<std::uint32_t>(chunks * slot / participants),
+                          static_cast<std::uint32_t>(chunks * (slot + 1) / participants));
+    }
+  }
+
+  // Processes the chunks of the given slot, then steals from the others until no chunks are left
+  void Process(std::size_t slot) {
+    details::ParallelLoopScope scope{};
+    details::ChunkRange& own = ranges_[slot];
+    std::uint32_t chunk = 0;
+    while (true) {
+      while (own.Pop(chunk)) {
+        if (!RunChunk(chunk))
+          return;
+      }
+      if (!StealInto(slot))
+        return;
+    }
+  }
+
+  // Only call these while holding the mutex of the pool
+  bool CanJoin() const { return next_slot_ < participants_; }
+  std::size_t Join() {
+    running_++;
+    return next_slot_++;
+  }
+  bool Leave() { return --running_ == 0; }
+  bool IsRunning() const { return running_ != 0; }
+  void RethrowError() const {
+    if (error_)
+      std::rethrow_exception(error_);
+  }
+
+ private:
+  template <typename Body> static void Run(const void* body, std::size_t begin, std::size_t end) {
+    (*static_cast<const Body*>(body))(begin, end);
+  }
+
+  bool RunChunk(std::uint32_t chunk) {
+    if (cancelled_.load(std::memory_order_relaxed))
+      return false;
+    const std::size_t begin = offset_ + chunk * grain_;
+    const std::size_t end = std::min(begin + grain_, offset_ + count_);
+    try {
+      run_(body_, begin, end);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex_);
+      if (!error_)
+        error_ = std::current_exception();
+      cancelled_.store(true, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  }
+
+  bool StealInto(std::size_t slot) {
+    for (std::size_t i = 1; i < participants_; i++) {
+      std::uint32_t begin = 0, end = 0;
+      if (ranges_[(slot + i) % participants_].Steal(begin, end)) {
+        ranges_[slot].Reset(begin, end);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void (*run_)(const void* body, std::size_t begin, std::size_t end);
+  const void* body_;
+  std::size_t offset_;
+  std::size_t count_;
+  std::size_t grain_;
+  std::size_t participants_;
+  std::unique_ptr<details::ChunkRange[]> ranges_;
+  std::atomic<bool> cancelled_{false};
+  std::mutex error_mutex_;
+  std::exception_ptr error_;
+  std::size_t next_slot_ = 0;  // Slot 0 is taken by the calling thread, before the workers are woken up
+  std::size_t running_ = 0;
+};
+
+inline ThreadPool::ThreadPool(std::size_t concurrency) {
+  for (std::size_t i = 1; i < concurrency; i++)
+    workers_.emplace_back([this] { WorkerLoop(); });
+}
+
+inline ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& worker : workers_)
+    worker.join();
+}
+
+inline void ThreadPool::WorkerLoop() {
+  std::uint64_t seen_generation = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    wake_.wait(lock, [this, &seen_generation] { return stopping_ || generation_ != seen_generation; });
+    if (stopping_)
+      return;
+    seen_generation = generation_;
+    if (job_ == nullptr || !job_->CanJoin())
+      continue;
+    Job* job = job_;
+    const std::size_t slot = job->Join();
+    lock.unlock();
+    job->Process(slot);
+    lock.lock();
+    if (job->Leave())
+      done_.notify_all();
+  }
+}
+
+template <typename Body> void ThreadPool::ParallelFor(std::size_t count, const Body& body) {
+  if (workers_.empty() || details::InParallelLoop()) {
+    if (count != 0)
+      body(0, count);
+    return;
+  }
+
+  // Measures the cost of an element by processing a growing number of elements on the calling thread
+  using _clock = std::chrono::steady_clock;
+  const _clock::time_point start = _clock::now();
+  std::size_t measured = 0;
+  _clock::duration elapsed{};
+  for (std::size_t batch = 1; measured < count && elapsed < details::kMeasureTime; batch *= 2) {
+    const std::size_t end = std::min(count, measured + batch);
+    {
+      details::ParallelLoopScope scope{};
+      body(measured, end);
+    }
+    measured = end;
+    elapsed = _clock::now() - start;
+  }
+
+  const std::size_t remaining = count - measured;
+  if (remaining == 0)
+    return;
+  const auto nanoseconds_per_element =
+      std::max<std::int64_t>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / measured);
+  const std::size_t max_grain = std::max<std::size_t>(1, remaining / (Concurrency() * details::kChunksPerThread));
+  const auto target_nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(details::kTargetChunkTime);
+  const std::size_t target_grain = static_cast<std::size_t>(target_nanoseconds.count() / nanoseconds_per_element);
+  std::size_t grain = std::max<std::size_t>(1, std::min(max_grain, target_grain));
+  // Chunks are numbered with 32 bits
+  grain = std::max(grain, remaining / UINT32_MAX + 1);
+  const std::size_t chunks = (remaining + grain - 1) / grain;
+
+  std::lock_guard<std::mutex> job_lock(job_mutex_);
+  Job job{body, measured, remaining, grain, std::min(Concurrency(), chunks)};
+  std::size_t slot = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job_ = &job;
+    generation_++;
+    slot = job.Join();
+  }
+  wake_.notify_all();
+  job.Process(slot);
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    job_ = nullptr;
+    job.Leave();
+    done_.wait(lock, [&job] { return !job.IsRunning(); });
+  }
+  job.RethrowError();
+}
+
+inline ThreadPool& DefaultThreadPool() {
+  static ThreadPool pool{};
+  return pool;
+}
+
+namespace details {
+
+// Splits a random-access collection by element
+template <typename T> class ElementRanges {
+ public:
+  // True if the ranges count elements, rather than nested collections
+  static constexpr bool kCountsElements = true;
+
+  explicit ElementRanges(T& iterable)
+      : first_(std::begin(iterable)), count_(static_cast<std::size_t>(std::end(iterable) - first_)) {}
+
+  std::size_t Count() const { return count_; }
+
+  // Calls 'function(element)' for the elements in [begin, end)
+  template <typename Function> void Visit(std::size_t begin, std::size_t end, Function& function) const {
+    auto it = first_ + static_cast<std::ptrdiff_t>(begin);
+    for (std::size_t i = begin; i < end; i++, ++it)
+      function(*it);
+  }
+
+ private:
+  decltype(std::begin(std::declval<T&>())) first_;
+  std::size_t count_;
+};
+
+// The nested collections of 'Chain(T)', which can be const
+template <typename T>
+using chained_collection_t = remove_reference_t<decltype(*std::begin(std::declval<T&>().Collections()))>;
+
+// Splits a chain by the elements of its nested collections (if those are random-access),
+// so a single huge nested collection is spread over all threads.
+// The prefix sums of the sizes tell where every nested collection starts.
+template <typename T> class ChainedElementRanges {
+ public:
+  static constexpr bool kCountsElements = true;
+
+  explicit ChainedElementRanges(T& chained) {
+    for (auto& collection : chained.Collections()) {
+      collections_.push_back(&collection);
+      starts_.push_back(count_);
+      count_ += collection.size();
+    }
+  }
+
+  std::size_t Count() const { return count_; }
+
+  template <typename Function> void Visit(std::size_t begin, std::size_t end, Function& function) const {
+    // The last collection starting at (or before) 'begin', which skips all empty collections starting there
+    const auto start = std::upper_bound(starts_.begin(), starts_.end(), begin) - 1;
+    std::size_t index = static_cast<std::size_t>(start - starts_.begin());
+    for (; begin < end; index++) {
+      _collection& collection = *collections_[index];
+      const std::size_t offset = begin - starts_[index];
+      const std::size_t count = std::min(end - begin, collection.size() - offset);
+      auto it = std::begin(collection) + static_cast<std::ptrdiff_t>(offset);
+      for (std::size_t i = 0; i < count; i++, ++it)
+        function(*it);
+      begin += count;
+    }
+  }
+
+ private:
+  using _collection = chained_collection_t<T>;
+
+  std::vector<_collection*> collections_{};
+  std::vector<std::size_t> starts_{};
+  std::size_t count_ = 0;
+};
+
+// Splits a chain by its nested collections, for nested collections that can not be split themselves.
+// Stealing still balances the work, but a single nested collection is always processed by a single thread.
+template <typename T> class ChainedCollectionRanges {
+ public:
+  static constexpr bool kCountsElements = false;
+
+  explicit ChainedCollectionRanges(T& chained) {
+    for (auto& collection : chained.Collections())
+      collections_.push_back(&collection);
+  }
+
+  std::size_t Count() const { return collections_.size(); }
+
+  template <typename Function> void Visit(std::size_t begin, std::size_t end, Function& function) const {
+    for (std::size_t index = begin; index < end; index++)
+      details::ForEach(*collections_[index], function);
+  }
+
+ private:
+  std::vector<chained_collection_t<T>*> collections_{};
+};
+
+template <typename T> struct is_chained : std::false_type {};
+template <typename T> struct is_chained<Chained<T>> : std::true_type {};
+template <typename T> struct is_chained<ForwardChained<T>> : std::true_type {};
+
+template <typename T>
+using can_split_chained_collections =
+    conjunction<has_size<chained_collection_t<T>>, is_random_access_collection<chained_collection_t<T>>>;
+
+template <typename T> ChainedElementRanges<T> MakeChainedRanges(T& chained, std::true_type /* can_split */) {
+  return ChainedElementRanges<T>{chained};
+}
+template <typename T> ChainedCollectionRanges<T> MakeChainedRanges(T& chained, std::false_type /* can_split */) {
+  return ChainedCollectionRanges<T>{chained};
+}
+
+// Splits any other collection in halves (see 'split_at'), and those halves again, until there are enough pieces
+// to balance the work, e.g. a filter, a join of 2 lists or a zip of a vector with a list.
+// The pieces are processed as a whole, as a piece of a filter or a chain can't tell how many elements it holds.
+template <typename T> class SplitRanges {
+ public:
+  static constexpr bool kCountsElements = false;
+
+  SplitRanges(T& iterable, std::size_t pieces) {
+    auto halves = SplitAt(iterable, SplitSize(iterable) / 2);
+    Split(halves.first, pieces / 2);
+    Split(halves.second, pieces - pieces / 2);
+  }
+
+  std::size_t Count() const { return pieces_.size(); }
+
+  template <typename Function> void Visit(std::size_t begin, std::size_t end, Function& function) const {
+    for (std::size_t index = begin; index < end; index++)
+      details::ForEach(pieces_[index], function);
+  }
+
+ private:
+  // Splitting a half returns halves of the same type
+  using _piece = decltype(SplitAt(std::declval<T&>(), 0).first);
+
+  void Split(_piece& piece, std::size_t pieces) {
+    const std::size_t size = SplitSize(piece);
+    if (size == 0)
+      return;
+    if (pieces <= 1 || size == 1) {
+      pieces_.push_back(std::move(piece));
+      return;
+    }
+    auto halves = SplitAt(piece, size / 2);
+    Split(halves.first, pieces / 2);
+    Split(halves.second, pieces - pieces / 2);
+  }
+
+  std::vector<_piece> pieces_{};
+};
+
+template <typename T>
+ElementRanges<T> MakeUnchainedRanges(T& iterable, std::size_t, std::true_type /* is_random_access */) {
+  return ElementRanges<T>{iterable};
+}
+template <typename T>
+SplitRanges<T> MakeUnchainedRanges(T& iterable, std::size_t pieces, std::false_type /* is_random_access */) {
+  return SplitRanges<T>{iterable, pieces};
+}
+
+template <typename T> auto MakeRanges(T& iterable, std::size_t pieces, std::false_type /* is_chained */) {
+  return MakeUnchainedRanges(iterable, pieces, std::integral_constant<bool, is_random_access_collection<T>::value>{});
+}
+template <typename T> auto MakeRanges(T& chained, std::size_t, std::true_type /* is_chained */) {
+  return MakeChainedRanges(chained, std::integral_constant<bool, can_split_chained_collections<T>::value>{});
+}
+
+// Returns how to split 'iterable' in ranges that can be processed in parallel,
+// where 'pieces' is the number of pieces to split collections in that can't be split by element
+template <typename T> auto MakeRanges(T& iterable, std::size_t pieces) {
+  return MakeRanges(iterable, pieces, is_chained<remove_cv_t<T>>{});
+}
+template <typename T> auto MakeRanges(StoredReference<T>& iterable, std::size_t pieces) {
+  return MakeRanges(iterable.Get(), pieces);
+}
+template <typename T> auto MakeRanges(const StoredReference<T>& iterable, std::size_t pieces) {
+  return MakeRanges(iterable.Get(), pieces);
+}
+
+// Returns the collection stored in 'value' (see 'stored_t')
+template <typename T> const T& Unstored(const T& value) { return value; }
+template <typename T> const T& Unstored(const StoredReference<T>& value) { return value.Get(); }
+
+// Returns 'function(... function(partials[begin], partials[begin + 1]) ...)', combining both halves of the range
+// recursively so the shape of the tree only depends on the number of partial results
+template <typename Value, typename Function>
+Value CombinePairwise(std::vector<Value>& partials, std::size_t begin, std::size_t end, const Function& function) {
+  if (end - begin == 1)
+    return std::move(partials[begin]);
+  const std::size_t middle = begin + (end - begin) / 2;
+  Value first = CombinePairwise(partials, begin, middle, function);
+  return function(std::move(first), CombinePairwise(partials, middle, end, function));
+}
+
+// A sum that keeps track of the rounding error of every addition (Neumaier's variant of Kahan summation)
+template <typename T> class CompensatedSum {
+ public:
+  CompensatedSum() : CompensatedSum(T{}, T{}) {}
+
+  CompensatedSum Add(T value) const {
+    const T sum = sum_ + value;
+    // The low-order bits of the smaller operand that were lost when rounding 'sum'
+    const T error = Abs(sum_) >= Abs(value) ? (sum_ - sum) + value : (value - sum) + sum_;
+    return CompensatedSum{sum, compensation_ + error};
+  }
+  CompensatedSum Add(const CompensatedSum& other) const {
+    CompensatedSum result = Add(other.sum_);
+    result.compensation_ += other.compensation_;
+    return result;
+  }
+
+  T Result() const { return sum_ + compensation_; }
+
+ private:
+  CompensatedSum(T sum, T compensation) : sum_(sum), compensation_(compensation) {}
+
+  static T Abs(T value) { return value < T{} ? -value : value; }
+
+  T sum_;
+  T compensation_;
+};
+
+// Adds an element or a partial result to a 'CompensatedSum'
+struct add_compensated {
+  template <typename T, typename Value> CompensatedSum<T> operator()(const CompensatedSum<T>& sum, Value value) const {
+    return sum.Add(value);
+  }
+};
+
+template <typename T> struct is_filtered : std::false_type {};
+template <typename T, typename F> struct is_filtered<Filtered<T, F>> : std::true_type {};
+template <typename T, typename F> struct is_filtered<ForwardFiltered<T, F>> : std::true_type {};
+
+// The collection a filter of type 'T' selects its elements from
+template <typename T>
+using filtered_collection_t = remove_cvref_t<decltype(Unstored(std::declval<const T&>().Collection()))>;
+
+// True if 'T' is a filter over a random-access collection, whose selected elements can be compacted in parallel
+template <typename T, bool = is_filtered<T>::value> struct is_compactable_filter : std::false_type {};
+template <typename T>
+struct is_compactable_filter<T, true> : is_random_access_collection<const filtered_collection_t<T>> {};
+
+// Stores the offsets of the elements in [first, first + size) for which 'filter(element)' is true in 'selection',
+// and returns how many there are. Like 'SelectBlock', this does not branch on the outcome of the filter.
+template <typename Function, typename _iterator>
+std::size_t SelectRange(const Function& filter, _iterator first, std::size_t size, std::uint16_t* selection) {
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < size; i++, ++first) {
+    selection[count] = static_cast<std::uint16_t>(i);
+    count += static_cast<bool>(filter(*first));
+  }
+  return count;
+}
+// Contiguous elements are selected by 'SelectBlock', which vectorizes the loop for arithmetic values
+template <typename Function, typename Value>
+std::size_t SelectRange(const Function& filter, const Value* first, std::size_t size, std::uint16_t* selection) {
+  return SelectBlock(filter, Block<const Value>{first, size}, selection);
+}
+
+// Returns a pointer to the first element of a contiguous collection, and an iterator for all others
+template <typename T> auto FirstElement(const T& collection, std::true_type /* is_contiguous */) {
+  return collection.data();
+}
+template <typename T> auto FirstElement(const T& collection, std::false_type /* is_contiguous */) {
+  return std::begin(collection);
+}
+template <typename T> auto FirstElement(const T& collection) {
+  return FirstElement(collection, std::integral_constant<bool, is_contiguous_collection<T>::value>{});
+}
+
+}  // namespace details
+
+// Returned by 'Parallel': runs the terminal operations of a collection on a thread pool.
+//
+// Random-access collections are split by element.
+// Chains are split by the elements of the nested collections, so the work is balanced even if their sizes vary wildly
+// (or by nested collection, if those aren't random-access).
+// All other collections are split in halves (see 'split_at') into a few pieces per thread.
+template <typename T> class Parallelized {
+ public:
+  using _value = details::remove_cvref_t<decltype(*details::cbegin(std::declval<const details::stored_t<T>&>()))>;
+
+  Parallelized(T&& iterable, ThreadPool& pool) : iterable_(std::forward<T>(iterable)), pool_(&pool) {}
+
+  // Calls 'function(element)' for every element (see 'ParallelForEach')
+  template <typename Function> void for_each(Function function) {
+    const auto ranges = details::MakeRanges(iterable_, Pieces());
+    pool_->ParallelFor(ranges.Count(), [&ranges, &function](std::size_t begin, std::size_t end) {
+      ranges.Visit(begin, end, function);
+    });
+  }
+
+  // Reduces all the elements to a single value (see 'ParallelReduce')
+  template <typename Value, typename Function> Value reduce(Value identity, Function function) {
+    const auto ranges = details::MakeRanges(details::as_const(iterable_), Pieces());
+    std::mutex mutex;
+    std::vector<std::pair<std::size_t, Value>> partials{};
+    pool_->ParallelFor(ranges.Count(), [&](std::size_t begin, std::size_t end) {
+      Value partial = identity;
+      auto add = [&partial, &function](const auto& value) { partial = function(std::move(partial), value); };
+      ranges.Visit(begin, end, add);
+      std::lock_guard<std::mutex> lock(mutex);
+      partials.emplace_back(begin, std::move(partial));
+    });
+
+    std::sort(partials.begin(), partials.end(),
+              [](const auto& left, const auto& right) { return left.first < right.first; });
+    Value result = std::move(identity);
+    for (auto& partial : partials)
+      result = function(std::move(result), std::move(partial.second));
+    return result;
+  }
+
+  // Reduces all the elements to a single value, in an order that only depends on the number of elements
+  // (see 'ParallelDeterministicReduce')
+  template <typename Value, typename Function> Value deterministic_reduce(Value identity, Function function) {
+    const auto ranges = details::MakeRanges(details::as_const(iterable_), details::kDeterministicPieces);
+    const std::size_t count = ranges.Count();
+    // A block holds a fixed number of elements (or a single piece, if the ranges don't count elements)
+    const std::size_t block_size = decltype(ranges)::kCountsElements ? kBlockSize : 1;
+    const std::size_t blocks = (count + block_size - 1) / block_size;
+    if (blocks == 0)
+      return identity;
+
+    std::vector<Value> partials(blocks, identity);
+    pool_->ParallelFor(blocks, [&](std::size_t begin, std::size_t end) {
+      for (std::size_t block = begin; block < end; block++) {
+        Value& partial = partials[block];
+        auto add = [&partial, &function](const auto& value) { partial = function(std::move(partial), value); };
+        ranges.Visit(block * block_size, std::min(count, (block + 1) * block_size), add);
+      }
+    });
+    return details::CombinePairwise(partials, 0, blocks, function);
+  }
+
+  // Returns the sum of all the elements, in an order that only depends on the number of elements (see 'ParallelSum').
+  // Just like 'Sum', the sum has the type of 'element + element', so small integers are summed as 'int'.
+  auto sum(Summation summation = Summation::kPlain) {
+    static_assert(std::is_arithmetic<_value>::value, "Only arithmetic values can be summed");
+    using _sum = decltype(std::declval<_value>() + std::declval<_value>());
+    if (summation == Summation::kCompensated)
+      return deterministic_reduce(details::CompensatedSum<_sum>{}, details::add_compensated{}).Result();
+    return deterministic_reduce(_sum{}, [](_sum sum, _value value) { return sum + value; });
+  }
+
+  // Groups the elements by key and reduces the values of every group (see 'GroupReduce')
+  template <typename KeyFunction, typename ValueFunction, typename Function>
+  auto group_reduce(KeyFunction key_function, ValueFunction value_function, Function function) {
+    using _key = details::remove_cvref_t<decltype(key_function(std::declval<const _value&>()))>;
+    using _reduced = details::remove_cvref_t<decltype(value_function(std::declval<const _value&>()))>;
+    using _map = FlatMap<_key, _reduced>;
+
+    const auto ranges = details::MakeRanges(details::as_const(iterable_), Pieces());
+    const std::size_t partitions = Pieces();
+    // Only presize the tables if the number of elements is known without walking them
+    const std::size_t elements = decltype(ranges)::kCountsElements ? ranges.Count() : 0;
+    const std::size_t groups = std::min(elements / pool_->Concurrency(), details::kMaxPresizedGroups);
+
+    // Every chunk takes a set of tables that is not in use, so there are never more sets than threads
+    std::mutex mutex;
+    std::vector<std::unique_ptr<std::vector<_map>>> tables{};
+    std::vector<std::vector<_map>*> unused_tables{};
+    pool_->ParallelFor(ranges.Count(), [&](std::size_t begin, std::size_t end) {
+      std::vector<_map>* local_tables = nullptr;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (unused_tables.empty()) {
+          tables.push_back(std::make_unique<std::vector<_map>>(partitions, _map{groups / partitions}));
+          unused_tables.push_back(tables.back().get());
+        }
+        local_tables = unused_tables.back();
+        unused_tables.pop_back();
+      }
+      _map* const local = local_tables->data();
+      auto add = [&](const auto& value) {
+        _key key = key_function(value);
+        const std::uint64_t hash = local->HashOf(key);
+        local[Partition(hash, partitions)].Merge(hash, std::move(key), value_function(value), function);
+      };
+      ranges.Visit(begin, end, add);
+      std::lock_guard<std::mutex> lock(mutex);
+      unused_tables.push_back(local_tables);
+    });
+
+    // Merges the tables of every partition, and then appends the partitions (which hold different keys)
+    std::vector<_map> merged(partitions);
+    pool_->ParallelFor(partitions, [&](std::size_t begin, std::size_t end) {
+      for (std::size_t partition = begin; partition < end; partition++) {
+        for (auto& local_tables : tables)
+          merged[partition].Merge(std::move((*local_tables)[partition]), function);
+      }
+    });
+    std::size_t size = 0;
+    for (const auto& partition : merged)
+      size += partition.size();
+    _map result{size};
+    for (auto& partition : merged)
+      result.Merge(std::move(partition), function);
+    return result;
+  }
+
+  // Returns a std::vector with all the elements (see 'ParallelCollect')
+  auto collect() { return CollectFrom(details::Unstored(details::as_const(iterable_))); }
+
+ private:
+  std::size_t Pieces() const { return pool_->Concurrency() * details::kChunksPerThread; }
+
+  // Maps the upper 32 bits of 'hash' onto [0, partitions), as the lower bits pick the slot within a table
+  static std::size_t Partition(std::uint64_t hash, std::size_t partitions) {
+    return static_cast<std::size_t>(((hash >> 32) * partitions) >> 32);
+  }
+
+  template <typename _iterable> std::vector<_value> CollectFrom(const _iterable& iterable) {
+    return CollectFrom(iterable, std::integral_constant<bool, details::is_compactable_filter<_iterable>::value>{});
+  }
+  template <typename _iterable>
+  std::vector<_value> CollectFrom(const _iterable& iterable, std::false_type /* is_compactable_filter */) {
+    const auto ranges = details::MakeRanges(iterable, Pieces());
+    return Collect(ranges, std::integral_constant<bool, decltype(ranges)::kCountsElements>{});
+  }
+  // Compacts the elements selected by a filter in 2 passes over blocks of the nested collection,
+  // so the filter is called only once per element and the result is allocated only once:
+  //   - the first pass stores the offsets of the selected elements of every block,
+  //   - an exclusive prefix sum over the number of selected elements per block tells where every block starts,
+  //   - the second pass copies the selected elements of every block straight into their place in the result.
+  template <typename _iterable>
+  std::vector<_value> CollectFrom(const _iterable& filtered, std::true_type /* is_compactable_filter */) {
+    const auto& collection = details::Unstored(filtered.Collection());
+    const auto& filter = filtered.Predicate();
+    const auto first = details::FirstElement(collection);
+    const std::size_t size = static_cast<std::size_t>(std::end(collection) - std::begin(collection));
+    const std::size_t blocks = (size + kBlockSize - 1) / kBlockSize;
+
+    std::vector<std::uint16_t> selection(size);
+    std::vector<std::size_t> starts(blocks + 1, 0);
+    pool_->ParallelFor(blocks, [&](std::size_t begin, std::size_t end) {
+      for (std::size_t block = begin; block < end; block++) {
+        const std::size_t offset = block * kBlockSize;
+        const std::size_t block_size = std::min(kBlockSize, size - offset);
+        starts[block + 1] = details::SelectRange(filter, first + static_cast<std::ptrdiff_t>(offset), block_size,
+                                                 selection.data() + offset);
+      }
+    });
+    std::partial_sum(starts.begin(), starts.end(), starts.begin());
+
+    std::vector<_value> result(starts.back());
+    pool_->ParallelFor(blocks, [&](std::size_t begin, std::size_t end) {
+      for (std::size_t block = begin; block < end; block++) {
+        const std::size_t offset = block * kBlockSize;
+        const auto block_first = first + static_cast<std::ptrdiff_t>(offset);
+        const std::uint16_t* selected = selection.data() + offset;
+        const std::size_t count = starts[block + 1] - starts[block];
+        for (std::size_t i = 0; i < count; i++)
+          result[starts[block] + i] = block_first[selected[i]];
+      }
+    });
+    return result;
+  }
+
+  // Every element has its own index, so the threads can write them straight into the result
+  template <typename _ranges> std::vector<_value> Collect(const _ranges& ranges, std::true_type /* counts_elements */) {
+    std::vector<_value> result(ranges.Count());
+    pool_->ParallelFor(ranges.Count(), [&ranges, &result](std::size_t begin, std::size_t end) {
+      auto add = [&result, &begin](const auto& value) { result[begin++] = value; };
+      ranges.Visit(begin, end, add);
+    });
+    return result;
+  }
+  // Otherwise every range is collected on its own, and all of them are appended in order
+  template <typename _ranges>
+  std::vector<_value> Collect(const _ranges& ranges, std::false_type /* counts_elements */) {
+    std::vector<std::vector<_value>> parts(ranges.Count());
+    pool_->ParallelFor(ranges.Count(), [&ranges, &parts](std::size_t begin, std::size_t end) {
+      auto add = [&parts, begin](const auto& value) { parts[begin].push_back(value); };
+      ranges.Visit(begin, end, add);
+    });
+    std::vector<_value> result{};
+    for (auto& part : parts)
+      std::move(part.begin(), part.end(), std::back_inserter(result));
+    return result;
+  }
+
+  details::stored_t<T> iterable_;
+  ThreadPool* pool_;
+};
+
+template <typename T> auto Parallel(T&& iterable, ThreadPool& pool) {
+  return Parallelized<T>{std::forward<T>(iterable), pool};
+}
+
+namespace details {
+
+// The state of a single iteration over a 'ConcurrentlyMapped': the worker threads take the elements in order,
+// and store the mapped ones in a ring of 'capacity' slots, where element 'position' goes to slot 'position % capacity'
+template <typename Iterator, typename Function> class ConcurrentMapping {
+ public:
+  using _reference = decltype(*std::declval<Iterator&>());
+  // Elements that are references are passed on as is, temporaries are kept until they have been mapped
+  using _input =
+      conditional_t<std::is_lvalue_reference<_reference>::value, _reference, remove_cvref_t<_reference>>;
+  using value_type = remove_cvref_t<decltype(std::declval<const Function&>()(std::declval<_reference>()))>;
+
+  ConcurrentMapping(Iterator begin, Iterator end, const Function& function, std::size_t concurrency)
+      : next_(std::move(begin)),
+        end_(std::move(end)),
+        function_(function),
+        slots_(2 * std::max<std::size_t>(1, concurrency)) {
+    for (std::size_t i = 0; i < slots_.size() / 2; i++)
+      workers_.emplace_back([this] { Work(); });
+  }
+  ConcurrentMapping(const ConcurrentMapping&) = delete;
+  ConcurrentMapping& operator=(const ConcurrentMapping&) = delete;
+  ~ConcurrentMapping() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    space_.notify_all();
+    for (auto& worker : workers_)
+      worker.join();
+  }
+
+  // Returns the mapped element at 'position', waiting until it is available, or rethrows the exception it threw
+  const value_type& Get(std::size_t position) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    Slot& slot = WaitFor(position, lock);
+    if (slot.error)
+      std::rethrow_exception(slot.error);
+    return *slot.value;
+  }
+
+  // True if there is no element at 'position', waiting until that is known
+  bool AtEnd(std::size_t position) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    WaitFor(position, lock);
+    return position >= size_;
+  }
+
+  // Frees the slot of the element at 'position', once the caller moved on to the next one
+  void Release(std::size_t position) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      Slot& slot = WaitFor(position, lock);
+      slot.value.reset();
+      slot.error = nullptr;
+      slot.ready = false;
+      consumed_ = position + 1;
+    }
+    // A single slot got freed, so a single thread can take a new element
+    space_.notify_one();
+  }
+
+ private:
+  struct Slot {
+    std::unique_ptr<value_type> value{};
+    std::exception_ptr error{};
+    bool ready = false;
+  };
+
+  // Waits until the element at 'position' has been mapped, or is known to not exist
+  Slot& WaitFor(std::size_t position, std::unique_lock<std::mutex>& lock) {
+    Slot& slot = slots_[position % slots_.size()];
+    ready_.wait(lock, [&] { return slot.ready || position >= size_; });
+    return slot;
+  }
+
+  void Work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      space_.wait(lock, [this] { return stopping_ || next_position_ < consumed_ + slots_.size(); });
+      if (stopping_ || next_position_ >= size_)
+        return;
+      if (next_ == end_) {
+        size_ = next_position_;
+        ready_.notify_all();
+        space_.notify_all();
+        return;
+      }
+      const std::size_t position = next_position_++;
+      _input input = *next_;
+      ++next_;
+      lock.unlock();
+
+      Slot mapped{};
+      try {
+        mapped.value = std::make_unique<value_type>(function_(static_cast<_reference>(input)));
+      } catch (...) {
+        mapped.error = std::current_exception();
+      }
+      mapped.ready = true;
+
+      lock.lock();
+      slots_[position % slots_.size()] = std::move(mapped);
+      ready_.notify_one();
+    }
+  }
+
+  std::mutex mutex_;  // Guards all members below
+  std::condition_variable ready_;  // Signaled when an element has been mapped, or the end has been found
+                                   // (only the reading thread waits for it)
+  std::condition_variable space_;  // Signaled when a slot has been freed, or the threads must stop
+  Iterator next_;
+  Iterator end_;
+  const Function function_;
+  std::vector<Slot> slots_;
+  std::size_t next_position_ = 0;                                      // The position of the next element to map
+  std::size_t consumed_ = 0;                                           // The number of released elements
+  std::size_t size_ = std::numeric_limits<std::size_t>::max();  // The number of elements, once the end was reached
+  bool stopping_ = false;
+  std::vector<std::thread> workers_{};
+};
+
+template <typename Iterator, typename Function> class ConcurrentMappingIterator {
+ public:
+  using _mapping = ConcurrentMapping<Iterator, Function>;
+
+  using iterator_category = std::input_iterator_tag;
+  using value_type = typename _mapping::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const value_type*;
+  using reference = const value_type&;
+
+  // The end of every iteration
+  ConcurrentMappingIterator() = default;
+  explicit ConcurrentMappingIterator(std::shared_ptr<_mapping> mapping) : mapping_(std::move(mapping)) {}
+
+  // Returned by 'it++', which holds a copy of the element it was at
+  class PostIncremented {
+   public:
+    explicit PostIncremented(value_type value) : value_(std::move(value)) {}
+
+    const value_type& operator*() const { return value_; }
+
+   private:
+    value_type value_;
+  };
+
+  reference operator*() const { return mapping_->Get(position_); }
+  pointer operator->() const { return &**this; }
+
+  ConcurrentMappingIterator& operator++() {
+    mapping_->Release(position_++);
+    return *this;
+  }
+  // Releases the current element, so 'it++' returns a copy of it for '*it++' (like std::istreambuf_iterator does)
+  PostIncremented operator++(int) {
+    PostIncremented result{**this};
+    ++*this;
+    return result;
+  }
+
+  bool operator==(const ConcurrentMappingIterator& other) const {
+    if (mapping_ && other.mapping_)
+      return position_ == other.position_;
+    return AtEnd() && other.AtEnd();
+  }
+  bool operator!=(const ConcurrentMappingIterator& other) const { return !(*this == other); }
+
+ private:
+  bool AtEnd() const { return !mapping_ || mapping_->AtEnd(position_); }
+
+  std::shared_ptr<_mapping> mapping_{};
+  std::size_t position_ = 0;
+};
+
+}  // namespace details
+
+// Returned by 'MapConcurrent'
+template <typename T, typename Function>
+class ConcurrentlyMapped : public WithChainedOperators<ConcurrentlyMapped<T, Function>> {
+ public:
+  using _iterable_iterator = decltype(details::cbegin(std::declval<const details::stored_t<T>&>()));
+  using _mapping = details::ConcurrentMapping<_iterable_iterator, Function>;
+
+  using value_type = typename _mapping::value_type;
+  using const_iterator = details::ConcurrentMappingIterator<_iterable_iterator, Function>;
+  using iterator = const_iterator;
+
+  ConcurrentlyMapped(T&& iterable, Function function, std::size_t concurrency)
+      : iterable_(std::forward<T>(iterable)), function_(std::move(function)), concurrency_(concurrency) {}
+
+  // Starts the threads that map the elements
+  const_iterator begin() const {
+    return const_iterator{std::make_shared<_mapping>(details::cbegin(iterable_), details::cend(iterable_), function_,
+                                                     concurrency_)};
+  }
+  const_iterator end() const { return const_iterator{}; }
+
+ private:
+  details::stored_t<T> iterable_;
+  Function function_;
+  std::size_t concurrency_;
+};
+
+template <typename T, typename Function> auto MapConcurrent(T&& iterable, Function function, std::size_t concurrency) {
+  return ConcurrentlyMapped<T, Function>{std::forward<T>(iterable), std::move(function), concurrency};
+}
+
+namespace details {
+
+// The state of a single iteration over an 'AsyncBuffered': a thread iterates over [begin, end),
+// and pushes the elements in batches through 'full_', while the emptied batches go back through 'empty_',
+// so their memory is reused
+template <typename Iterator> class AsyncBuffering {
+ public:
+  using value_type = remove_cvref_t<decltype(*std::declval<Iterator&>())>;
+  using _batch = std::vector<value_type>;
+
+  AsyncBuffering(Iterator begin, Iterator end, std::size_t capacity)
+      : batch_size_(std::max<std::size_t>(1, std::min(capacity / 4, kMaxAsyncBatchSize))),
+        full_(std::max<std::size_t>(2, capacity / batch_size_)),
+        empty_(std::max<std::size_t>(2, capacity / batch_size_) + 1) {
+    producer_ = std::thread([this, begin, end]() mutable { Produce(std::move(begin), std::move(end)); });
+  }
+  AsyncBuffering(const AsyncBuffering&) = delete;
+  AsyncBuffering& operator=(const AsyncBuffering&) = delete;
+  ~AsyncBuffering() {
+    stopping_.store(true, std::memory_order_relaxed);
+    producer_.join();
+  }
+
+  const value_type& Current() {
+    AtEnd();  // Waits for the next batch if the current one has been read
+    return batch_[index_];
+  }
+
+  // True if there are no elements left, waiting for the next batch if needed
+  bool AtEnd() {
+    while (index_ == batch_.size() && !finished_) {
+      batch_.clear();
+      empty_.TryPush(batch_);
+      batch_.clear();  // In case it was moved into the ring
+      Await([this] { return full_.TryPop(batch_) || done_.load(std::memory_order_acquire); });
+      // Anything pushed before 'done_' was set is still in the ring
+      if (batch_.empty() && !full_.TryPop(batch_)) {
+        finished_ = true;
+        if (error_)
+          std::rethrow_exception(error_);
+      }
+      index_ = 0;
+    }
+    return index_ == batch_.size();
+  }
+
+  void Advance() {
+    AtEnd();
+    index_++;
+  }
+
+ private:
+  void Produce(Iterator it, Iterator end) {
+    _batch batch{};
+    try {
+      for (; it != end; ++it) {
+        if (batch.empty() && empty_.TryPop(batch))
+          batch.clear();
+        batch.push_back(*it);
+        if (batch.size() == batch_size_ && !Push(batch))
+          return;
+      }
+    } catch (...) {
+      error_ = std::current_exception();
+    }
+    // The last elements (before the end or the exception)
+    if (!batch.empty() && !Push(batch))
+      return;
+    done_.store(true, std::memory_order_release);
+  }
+
+  // Pushes 'batch' once there is room for it, returns false if the reader went away first
+  bool Push(_batch& batch) {
+    Await([&] { return full_.TryPush(batch) || stopping_.load(std::memory_order_relaxed); });
+    batch.clear();  // In case it was moved into the ring
+    return !stopping_.load(std::memory_order_relaxed);
+  }
+
+  const std::size_t batch_size_;
+  SpscRing<_batch> full_;   // Batches of elements, from the thread to the reader
+  SpscRing<_batch> empty_;  // Batches that have been read, from the reader back to the thread
+  std::exception_ptr error_{};  // Set by the thread before it sets 'done_'
+  std::atomic<bool> done_{false};
+  std::atomic<bool> stopping_{false};
+  // Only used by the reader
+  _batch batch_{};
+  std::size_t index_ = 0;
+  bool finished_ = false;
+  std::thread producer_{};
+};
+
+template <typename Iterator> class AsyncBufferIterator {
+ public:
+  using _buffering = AsyncBuffering<Iterator>;
+
+  using iterator_category = std::input_iterator_tag;
+  using value_type = typename _buffering::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const value_type*;
+  using reference = const value_type&;
+
+  // The end of every iteration
+  AsyncBufferIterator() = default;
+  explicit AsyncBufferIterator(std::shared_ptr<_buffering> buffering) : buffering_(std::move(buffering)) {}
+
+  reference operator*() const { return buffering_->Current(); }
+  pointer operator->() const { return &**this; }
+
+  AsyncBufferIterator& operator++() {
+    buffering_->Advance();
+    return *this;
+  }
+  void operator++(int) { ++*this; }
+
+  // All iterators of an iteration share their position, so they are only ever compared with the end
+  bool operator==(const AsyncBufferIterator& other) const { return AtEnd() == other.AtEnd(); }
+  bool operator!=(const AsyncBufferIterator& other) const { return !(*this == other); }
+
+ private:
+  bool AtEnd() const { return !buffering_ || buffering_->AtEnd(); }
+
+  std::shared_ptr<_buffering> buffering_{};
+};
+
+}  // namespace details
+
+// Returned by 'AsyncBuffer'
+template <typename T> class AsyncBuffered : public WithChainedOperators<AsyncBuffered<T>> {
+ public:
+  using _iterable_iterator = decltype(details::cbegin(std::declval<const details::stored_t<T>&>()));
+  using _buffering = details::AsyncBuffering<_iterable_iterator>;
+
+  using value_type = typename _buffering::value_type;
+  using const_iterator = details::AsyncBufferIterator<_iterable_iterator>;
+  using iterator = const_iterator;
+
+  AsyncBuffered(T&& iterable, std::size_t capacity) : iterable_(std::forward<T>(iterable)), capacity_(capacity) {}
+
+  // Starts the thread that iterates over the nested collection
+  const_iterator begin() const {
+    return const_iterator{
+        std::make_shared<_buffering>(details::cbegin(iterable_), details::cend(iterable_), capacity_)};
+  }
+  const_iterator end() const { return const_iterator{}; }
+
+ private:
+  details::stored_t<T> iterable_;
+  std::size_t capacity_;
+};
+
+template <typename T> auto AsyncBuffer(T&& iterable, std::size_t capacity) {
+  return AsyncBuffered<T>{std::forward<T>(iterable), capacity};
+}
+}  // namespace iterators
+
+#endif  // _CPP_ITERATORS_PARALLEL_H_
@@ -0,0 +1,242 @@
+
+#include "parallel.h"
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "benchmark/benchmark.h"
+
+namespace iterators {
+namespace {
+
+constexpr int kElements = 1 << 16;
+
+std::vector<double> MakeVector(int size) {
+  std::vector<double> result(size);
+  for (int i = 0; i < size; i++)
+    result[i] = i;
+  return result;
+}
+
+// Takes about a microsecond per element
+double Expensive(double value) {
+  for (int i = 0; i < 200; i++)
+    value = std::sqrt(value + i);
+  return value;
+}
+
+// Runs the benchmark with 1 to N threads, where N is the number of cores
+void ThreadCounts(benchmark::internal::Benchmark* benchmark) {
+  const int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  for (int threads = 1; threads <= cores; threads *= 2)
+    benchmark->Arg(threads);
+  if ((cores & (cores - 1)) != 0)
+    benchmark->Arg(cores);
+  benchmark->UseRealTime();
+}
+
+void BM_Map_Expensive_ForEach(benchmark::State& state) {
+  auto values = MakeVector(kElements);
+  double sum = 0;
+  for (auto _ : state) {
+    Iterate(values).map(Expensive).for_each([&sum](double value) { sum += value; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+BENCHMARK(BM_Map_Expensive_ForEach)->UseRealTime();
+
+void BM_Map_Expensive_ParallelReduce(benchmark::State& state) {
+  ThreadPool pool{static_cast<std::size_t>(state.range(0))};
+  auto values = MakeVector(kElements);
+  for (auto _ : state) {
+    double sum = Iterate(values).map(Expensive).parallel(pool).reduce(0.0, [](double sum, double value) {
+      return sum + value;
+    });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+BENCHMARK(BM_Map_Expensive_ParallelReduce)->Apply(ThreadCounts);
+
+void BM_Map_Expensive_ParallelCollect(benchmark::State& state) {
+  ThreadPool pool{static_cast<std::size_t>(state.range(0))};
+  auto values = MakeVector(kElements);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(Iterate(values).map(Expensive).parallel(pool).collect());
+  state.SetItemsProcessed(state.iterations() * kElements);
+}
+BENCHMARK(BM_Map_Expensive_ParallelCollect)->Apply(ThreadCounts);
+
+// Cheap elements, where the chunks must be big enough to hide the cost of scheduling them
+void BM_Map_Cheap_ParallelReduce(benchmark::State& state) {
+  ThreadPool pool{static_cast<std::size_t>(state.range(0))};
+  auto values = MakeVector(kElements * 16);
+  for (auto _ : state) {
+    auto doubled = Iterate(values).map([](double value) { return value * 2; });
+    double sum = std::move(doubled).parallel(pool).reduce(0.0, [](double sum, double value) { return sum + value; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kElements * 16);
+}
+BENCHMARK(BM_Map_Cheap_ParallelReduce)->Apply(ThreadCounts);
+
+// The same sum with a reproducible result, so this should be about as fast as 'BM_Map_Cheap_ParallelReduce'
+void BM_Map_Cheap_ParallelSum(benchmark::State& state) {
+  ThreadPool pool{static_cast<std::size_t>(state.range(0))};
+  auto values = MakeVector(kElements * 16);
+  for (auto _ : state) {
+    auto doubled = Iterate(values).map([](double value) { return value * 2; });
+    benchmark::DoNotOptimize(std::move(doubled).parallel(pool).sum());
+  }
+  state.SetItemsProcessed(state.iterations() * kElements * 16);
+}
+BENCHMARK(BM_Map_Cheap_ParallelSum)->Apply(ThreadCounts);
+
+void BM_Map_Cheap_ParallelSum_Compensated(benchmark::State& state) {
+  ThreadPool pool{static_cast<std::size_t>(state.range(0))};
+  auto values = MakeVector(kElements * 16);
+  for (auto _ : state) {
+    auto doubled = Iterate(values).map([](double value) { return value * 2; });
+    benchmark::DoNotOptimize(std::move(doubled).parallel(pool).sum(Summation::kCompensated));
+  }
+  state.SetItemsProcessed(state.iterations() * kElements * 16);
+}
+BENCHMARK(BM_Map_Cheap_ParallelSum_Compensated)->Apply(ThreadCounts);
+
+// Keeps about a third of the values
+bool IsSelected(double value) { return static_cast<long>(value) % 3 == 0; }
+
+void BM_Filter_Collect(benchmark::State& state) {
+  auto values = MakeVector(kElements * 64);
+  for (auto _ : state) {
+    auto selected = Filter(values, IsSelected);
+    benchmark::DoNotOptimize(std::vector<double>(selected.begin(), selected.end()));
+  }
+  state.SetItemsProcessed(state.iterations() * kElements * 64);
+}
+BENCHMARK(BM_Filter_Collect)->UseRealTime();
+
+void BM_Filter_ParallelCollect(benchmark::State& state) {
+  ThreadPool pool{static_cast<std::size_t>(state.range(0))};
+  auto values = MakeVector(kElements * 64);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(Filter(values, IsSelected).parallel(pool).collect());
+  state.SetItemsProcessed(state.iterations() * kElements * 64);
+}
+BENCHMARK(BM_Filter_ParallelCollect)->Apply(ThreadCounts);
+
+// About a thousand groups, like counting the distinct values of a column
+const auto GroupOf = [](double value) { return static_cast<long>(value) % 1024; };
+
+void BM_GroupSum(benchmark::State& state) {
+  auto values = MakeVector(kElements * 16);
+  for (auto _ : state) {
+    std::unordered_map<long, double> sums{};
+    for (double value : values)
+      sums[GroupOf(value)] += value;
+    benchmark::DoNotOptimize(sums);
+  }
+  state.SetItemsProcessed(state.iterations() * kElements * 16);
+}
+BENCHMARK(BM_GroupSum)->UseRealTime();
+
+void BM_GroupSum_ParallelGroupReduce(benchmark::State& state) {
+  ThreadPool pool{static_cast<std::size_t>(state.range(0))};
+  auto values = MakeVector(kElements * 16);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Iterate(values).parallel(pool).group_reduce(
+        GroupOf, [](double value) { return value; }, [](double sum, double value) { return sum + value; }));
+  }
+  state.SetItemsProcessed(state.iterations() * kElements * 16);
+}
+BENCHMARK(BM_GroupSum_ParallelGroupReduce)->Apply(ThreadCounts);
+
+// Stands in for a call that waits on I/O (like an RPC), so it takes the same time regardless of the number of cores
+double Sleepy(double value) {
+  std::this_thread::sleep_for(std::chrono::microseconds(100));
+  return value;
+}
+
+constexpr int kSleepyElements = 256;
+
+void BM_Map_Sleepy(benchmark::State& state) {
+  auto values = MakeVector(kSleepyElements);
+  for (auto _ : state) {
+    for (double value : Iterate(values).map(Sleepy))
+      benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations() * kSleepyElements);
+}
+BENCHMARK(BM_Map_Sleepy)->UseRealTime();
+
+// Should be about 'concurrency' times faster than 'BM_Map_Sleepy', even on a single core
+void BM_Map_Sleepy_MapConcurrent(benchmark::State& state) {
+  const auto concurrency = static_cast<std::size_t>(state.range(0));
+  auto values = MakeVector(kSleepyElements);
+  for (auto _ : state) {
+    for (double value : Iterate(values).map_concurrent(Sleepy, concurrency))
+      benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations() * kSleepyElements);
+}
+BENCHMARK(BM_Map_Sleepy_MapConcurrent)->RangeMultiplier(4)->Range(1, 64)->UseRealTime();
+
+// Two expensive stages, which should take about half as long with 'async_buffer' between them on 2 cores
+void BM_TwoStages(benchmark::State& state) {
+  auto values = MakeVector(kElements / 16);
+  for (auto _ : state) {
+    for (double value : Iterate(values).map(Expensive).map(Expensive))
+      benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations() * kElements / 16);
+}
+BENCHMARK(BM_TwoStages)->UseRealTime();
+
+void BM_TwoStages_AsyncBuffer(benchmark::State& state) {
+  auto values = MakeVector(kElements / 16);
+  for (auto _ : state) {
+    for (double value : Iterate(values).map(Expensive).async_buffer(1024).map(Expensive))
+      benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations() * kElements / 16);
+}
+BENCHMARK(BM_TwoStages_AsyncBuffer)->UseRealTime();
+
+// Cheap elements, where the cost of handing them over between the threads dominates
+void BM_AsyncBuffer_Cheap(benchmark::State& state) {
+  auto values = MakeVector(kElements * 16);
+  for (auto _ : state) {
+    double sum = 0;
+    for (double value : Iterate(values).async_buffer(4096))
+      sum += value;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kElements * 16);
+}
+BENCHMARK(BM_AsyncBuffer_Cheap)->UseRealTime();
+
+// Shards whose sizes vary by 1000x, where a single shard holds half of all the elements
+std::vector<std::vector<double>> MakeIrregularShards() {
+  std::vector<std::vector<double>> result{};
+  result.push_back(MakeVector(kElements / 2));
+  for (int i = 0; i < 64; i++)
+    result.push_back(MakeVector(i % 8 == 0 ? kElements / 32 : kElements / 32000 + 1));
+  return result;
+}
+
+void BM_Chain_Irregular_ParallelForEach(benchmark::State& state) {
+  ThreadPool pool{static_cast<std::size_t>(state.range(0))};
+  auto shards = MakeIrregularShards();
+  const auto elements = static_cast<std::int64_t>(Count(Chain(shards)));
+  for (auto _ : state)
+    Chain(shards).parallel(pool).for_each([](double value) { benchmark::DoNotOptimize(Expensive(value)); });
+  state.SetItemsProcessed(state.iterations() * elements);
+}
+BENCHMARK(BM_Chain_Irregular_ParallelForEach)->Apply(ThreadCounts);
+
+}  // namespace
+}  // namespace iterators
+
+BENCHMARK_MAIN();
@@ -0,0 +1,685 @@
+
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace iterators {
+using std::string;
+using std::vector;
+using testing::ElementsAre;
+
+constexpr int kThreads = 4;
+
+vector<int> MakeValues(int size) {
+  vector<int> result(size);
+  std::iota(result.begin(), result.end(), 0);
+  return result;
+}
+
+TEST(ThreadPoolTest, ProcessesEveryElementOnce) {
+  ThreadPool pool{kThreads};
+  vector<std::atomic<int>> visits(100000);
+  pool.ParallelFor(visits.size(), [&visits](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++)
+      visits[i]++;
+  });
+
+  for (const auto& count : visits)
+    ASSERT_EQ(1, count.load());
+}
+
+TEST(ThreadPoolTest, UsesAllThreadsForExpensiveElements) {
+  ThreadPool pool{kThreads};
+  std::mutex mutex;
+  std::set<std::thread::id> threads{};
+  pool.ParallelFor(200, [&](std::size_t, std::size_t) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::lock_guard<std::mutex> lock(mutex);
+    threads.insert(std::this_thread::get_id());
+  });
+
+  EXPECT_EQ(kThreads, threads.size());
+}
+
+TEST(ThreadPoolTest, SupportsEmptyRange) {
+  ThreadPool pool{kThreads};
+  int calls = 0;
+  pool.ParallelFor(0, [&calls](std::size_t, std::size_t) { calls++; });
+
+  EXPECT_EQ(0, calls);
+}
+
+TEST(ThreadPoolTest, PoolWithoutThreadsRunsOnCallingThread) {
+  ThreadPool pool{1};
+  const std::thread::id caller = std::this_thread::get_id();
+  pool.ParallelFor(1000, [caller](std::size_t, std::size_t) { EXPECT_EQ(caller, std::this_thread::get_id()); });
+
+  EXPECT_EQ(1, pool.Concurrency());
+}
+
+TEST(ThreadPoolTest, RethrowsFirstException) {
+  ThreadPool pool{kThreads};
+  auto body = [](std::size_t begin, std::size_t end) {
+    if (begin <= 5000 && 5000 < end)
+      throw std::runtime_error("element 5000");
+  };
+
+  EXPECT_THROW(pool.ParallelFor(10000, body), std::runtime_error);
+  // The pool can still be used afterwards
+  std::atomic<int> count{0};
+  pool.ParallelFor(10000, [&count](std::size_t begin, std::size_t end) { count += static_cast<int>(end - begin); });
+  EXPECT_EQ(10000, count.load());
+}
+
+TEST(ThreadPoolTest, NestedLoopsRunOnCallingThread) {
+  ThreadPool pool{kThreads};
+  std::atomic<int> count{0};
+  pool.ParallelFor(100, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++)
+      pool.ParallelFor(100, [&count](std::size_t begin, std::size_t end) { count += static_cast<int>(end - begin); });
+  });
+
+  EXPECT_EQ(100 * 100, count.load());
+}
+
+TEST(ParallelTest, ForEach) {
+  ThreadPool pool{kThreads};
+  vector<int> values = MakeValues(100000);
+  std::atomic<long> sum{0};
+  Parallel(values, pool).for_each([&sum](int value) { sum += value; });
+
+  EXPECT_EQ(std::accumulate(values.begin(), values.end(), 0L), sum.load());
+}
+
+TEST(ParallelTest, ForEachCanModifyValues) {
+  ThreadPool pool{kThreads};
+  vector<int> values = MakeValues(100000);
+  Iterate(values).parallel(pool).for_each([](int& value) { value *= 2; });
+
+  EXPECT_EQ(2 * 99999, values.back());
+  EXPECT_EQ(2 * 50000, values[50000]);
+}
+
+TEST(ParallelTest, Reduce) {
+  ThreadPool pool{kThreads};
+  vector<int> values = MakeValues(100000);
+  auto add = [](long sum, long value) { return sum + value; };
+
+  EXPECT_EQ(std::accumulate(values.begin(), values.end(), 0L), Parallel(values, pool).reduce(0L, add));
+  EXPECT_EQ(std::accumulate(values.begin(), values.end(), 0L), ParallelReduce(values, 0L, add));
+}
+
+TEST(ParallelTest, ReduceCombinesInOrder) {
+  ThreadPool pool{kThreads};
+  vector<string> values{};
+  for (int i = 0; i < 10000; i++)
+    values.push_back(std::to_string(i % 10));
+  auto concatenate = [](string result, const string& value) { return result + value; };
+
+  EXPECT_EQ(std::accumulate(values.begin(), values.end(), string{}, concatenate),
+            Parallel(values, pool).reduce(string{}, concatenate));
+}
+
+// Floats of wildly different magnitudes, whose sum depends on the order in which they are added
+vector<float> MakeFloats(int size) {
+  vector<float> result(size);
+  for (int i = 0; i < size; i++)
+    result[i] = static_cast<float>((i * 7919) % 1000) * (i % 3 == 0 ? 1e-3f : 1e3f) + 0.1f;
+  return result;
+}
+
+TEST(ParallelTest, DeterministicReduceDoesNotDependOnThreads) {
+  vector<float> values = MakeFloats(200000);
+  auto add = [](float sum, float value) { return sum + value; };
+  vector<float> sums{};
+  vector<float> compensated_sums{};
+  for (std::size_t threads : {1, 2, 3, 4, 7}) {
+    ThreadPool pool{threads};
+    sums.push_back(Parallel(values, pool).deterministic_reduce(0.0f, add));
+    sums.push_back(Iterate(values).parallel(pool).sum());
+    compensated_sums.push_back(Iterate(values).parallel(pool).sum(Summation::kCompensated));
+  }
+
+  EXPECT_THAT(sums, testing::Each(sums[0]));
+  EXPECT_THAT(compensated_sums, testing::Each(compensated_sums[0]));
+}
+
+TEST(ParallelTest, DeterministicReduceOverSplitCollections) {
+  vector<float> values = MakeFloats(50000);
+  std::list<float> other(values.begin(), values.end());
+  auto product = [](const auto& item) { return item.First() * item.Second(); };
+  auto is_large = [](float value) { return value > 100; };
+  vector<float> sums{};
+  vector<float> filtered_sums{};
+  for (std::size_t threads : {1, 2, 4}) {
+    ThreadPool pool{threads};
+    sums.push_back(Zip(values, other).map(product).parallel(pool).sum());
+    filtered_sums.push_back(Filter(other, is_large).parallel(pool).sum());
+  }
+
+  EXPECT_THAT(sums, testing::Each(sums[0]));
+  EXPECT_THAT(filtered_sums, testing::Each(filtered_sums[0]));
+}
+
+TEST(ParallelTest, CompensatedSumIsAccurate) {
+  // Every 1 added to 1e8 is lost when adding them one by one (as they all fit in a single block)
+  vector<float> values(1000, 1.0f);
+  values[0] = 1e8f;
+
+  EXPECT_EQ(1e8f, ParallelSum(values, Summation::kPlain));
+  EXPECT_EQ(1e8f + 999.0f, ParallelSum(values, Summation::kCompensated));
+}
+
+TEST(ParallelTest, SumPromotesSmallIntegers) {
+  vector<std::uint8_t> bytes(300, 1);
+
+  EXPECT_EQ(300, ParallelSum(bytes));
+  EXPECT_EQ(300, ParallelSum(bytes, Summation::kCompensated));
+}
+
+TEST(ParallelTest, DeterministicReduceCombinesInOrder) {
+  vector<string> values{};
+  for (int i = 0; i < 10000; i++)
+    values.push_back(std::to_string(i % 10));
+  auto concatenate = [](string result, const string& value) { return result + value; };
+
+  EXPECT_EQ(std::accumulate(values.begin(), values.end(), string{}, concatenate),
+            ParallelDeterministicReduce(values, string{}, concatenate));
+  EXPECT_EQ("x", ParallelDeterministicReduce(vector<string>{}, string{"x"}, concatenate));
+  EXPECT_EQ(0, ParallelSum(vector<int>{}));
+}
+
+TEST(ParallelTest, Collect) {
+  ThreadPool pool{kThreads};
+  vector<int> values = MakeValues(100000);
+  vector<int> expected{};
+  for (int value : values)
+    expected.push_back(value * 3);
+
+  EXPECT_EQ(expected, Iterate(values).map([](int value) { return value * 3; }).parallel(pool).collect());
+  EXPECT_EQ(expected, ParallelCollect(Map(values, [](int value) { return value * 3; })));
+}
+
+TEST(ParallelTest, SupportsRandomAccessOperators) {
+  ThreadPool pool{kThreads};
+  vector<int> values = MakeValues(1000);
+  vector<int> reversed(values.rbegin(), values.rend());
+  vector<int> doubled = MakeValues(1000);
+  for (int& value : doubled)
+    value *= 2;
+
+  EXPECT_EQ(reversed, Reverse(values).parallel(pool).collect());
+  EXPECT_EQ(doubled, Zip(values, values)
+                         .map([](const auto& item) { return item.First() + item.Second(); })
+                         .parallel(pool)
+                         .collect());
+  EXPECT_EQ(doubled, Enumerate(values)
+                         .map([](const auto& item) { return item.Position() + item.Value(); })
+                         .parallel(pool)
+                         .collect());
+}
+
+TEST(ParallelTest, SupportsEmptyCollection) {
+  vector<int> values{};
+
+  EXPECT_THAT(ParallelCollect(values), ElementsAre());
+  EXPECT_EQ(7, ParallelReduce(values, 7, [](int sum, int value) { return sum + value; }));
+}
+
+TEST(ParallelSplitTest, Filter) {
+  ThreadPool pool{kThreads};
+  vector<int> values = MakeValues(100000);
+  auto is_odd = [](int value) { return value % 2 != 0; };
+  vector<int> expected{};
+  std::copy_if(values.begin(), values.end(), std::back_inserter(expected), is_odd);
+  auto add = [](long sum, long value) { return sum + value; };
+
+  EXPECT_EQ(expected, Iterate(values).filter(is_odd).parallel(pool).collect());
+  EXPECT_EQ(std::accumulate(expected.begin(), expected.end(), 0L),
+            Iterate(values).filter(is_odd).parallel(pool).reduce(0L, add));
+}
+
+TEST(ParallelSplitTest, FilterCallsFilterOncePerElement) {
+  ThreadPool pool{kThreads};
+  vector<int> values = MakeValues(100000);
+  std::atomic<int> calls{0};
+  auto is_small = [&calls](int value) {
+    calls++;
+    return (value * 7919) % 100 < 3;
+  };
+  vector<int> expected{};
+  std::copy_if(values.begin(), values.end(), std::back_inserter(expected), is_small);
+  calls = 0;
+
+  EXPECT_EQ(expected, ParallelCollect(Filter(values, is_small)));
+  EXPECT_EQ(100000, calls.load());
+}
+
+TEST(ParallelSplitTest, FilterOverMappedCollection) {
+  ThreadPool pool{kThreads};
+  vector<int> values = MakeValues(5000);
+  vector<string> expected{};
+  for (int value : values) {
+    if (value % 10 == 3)
+      expected.push_back(std::to_string(value));
+  }
+
+  EXPECT_EQ(expected, Map(values, [](int value) { return std::to_string(value); })
+                          .filter([](const string& value) { return value.back() == '3'; })
+                          .parallel(pool)
+                          .collect());
+  EXPECT_THAT(Filter(vector<int>{}, [](int) { return true; }).parallel(pool).collect(), ElementsAre());
+}
+
+TEST(ParallelSplitTest, FilterOverList) {
+  ThreadPool pool{kThreads};
+  std::list<int> values{};
+  for (int value : MakeValues(10000))
+    values.push_back(value);
+
+  EXPECT_EQ(MakeValues(5000), Filter(values, [](int value) { return value < 5000; }).parallel(pool).collect());
+}
+
+TEST(ParallelSplitTest, FilterCanModifyValues) {
+  ThreadPool pool{kThreads};
+  vector<int> values = MakeValues(100000);
+  Iterate(values).filter([](int value) { return value % 2 == 0; }).parallel(pool).for_each([](int& value) {
+    value = -value;
+  });
+
+  EXPECT_EQ(-99998, values[99998]);
+  EXPECT_EQ(99999, values[99999]);
+}
+
+TEST(ParallelSplitTest, JoinOfLists) {
+  ThreadPool pool{kThreads};
+  vector<int> values = MakeValues(20000);
+  std::list<int> first(values.begin(), values.begin() + 5000);
+  std::list<int> second(values.begin() + 5000, values.end());
+
+  EXPECT_EQ(values, Join(first, second).parallel(pool).collect());
+}
+
+TEST(ParallelSplitTest, ZipOfVectorAndList) {
+  ThreadPool pool{kThreads};
+  vector<int> values = MakeValues(10000);
+  std::list<int> other(values.begin(), values.end());
+  auto add = [](long sum, long value) { return sum + value; };
+  auto product = [](const auto& item) { return static_cast<long>(item.First()) * item.Second(); };
+  long expected = 0;
+  for (int value : values)
+    expected += static_cast<long>(value) * value;
+
+  EXPECT_EQ(expected, Zip(values, other).map(product).parallel(pool).reduce(0L, add));
+}
+
+TEST(ParallelSplitTest, EnumerateOfFilter) {
+  ThreadPool pool{kThreads};
+  vector<int> values = MakeValues(10000);
+  auto positions = Iterate(values)
+                       .filter([](int value) { return value % 3 == 0; })
+                       .enumerate()
+                       .map([](const auto& item) { return item.Position(); })
+                       .parallel(pool)
+                       .collect();
+
+  EXPECT_EQ(MakeValues(3334), positions);
+}
+
+struct Record {
+  string key;
+  int value;
+};
+
+vector<Record> MakeRecords(int size) {
+  vector<Record> result{};
+  for (int i = 0; i < size; i++)
+    result.push_back(Record{"key" + std::to_string((i * 7919) % 997), i % 100});
+  return result;
+}
+
+TEST(GroupReduceTest, ReducesEveryGroup) {
+  ThreadPool pool{kThreads};
+  vector<Record> records = MakeRecords(100000);
+  std::map<string, long> expected{};
+  for (const Record& record : records)
+    expected[record.key] += record.value;
+  auto key = [](const Record& record) { return record.key; };
+  auto value = [](const Record& record) { return static_cast<long>(record.value); };
+
+  auto totals = Parallel(records, pool).group_reduce(key, value, std::plus<long>{});
+  EXPECT_EQ(expected, (std::map<string, long>(totals.begin(), totals.end())));
+}
+
+TEST(GroupReduceTest, OverFilteredCollection) {
+  ThreadPool pool{kThreads};
+  vector<int> values = MakeValues(100000);
+  auto is_even = [](int value) { return value % 2 == 0; };
+  std::map<int, int> expected{};
+  for (int value : values) {
+    if (is_even(value))
+      expected[value % 10] = std::max(expected[value % 10], value);
+  }
+  auto max = [](int first, int second) { return std::max(first, second); };
+
+  auto maxima = Filter(values, is_even).parallel(pool).group_reduce([](int value) { return value % 10; },
+                                                                    [](int value) { return value; }, max);
+  EXPECT_EQ(expected, (std::map<int, int>(maxima.begin(), maxima.end())));
+  EXPECT_EQ(99998, maxima.at(8));
+}
+
+TEST(GroupReduceTest, OverEmptyCollection) {
+  auto counts = GroupReduce(vector<int>{}, [](int value) { return value; }, [](int) { return 1; }, std::plus<int>{});
+
+  EXPECT_TRUE(counts.empty());
+}
+
+// Nested collections whose sizes vary wildly, with a single huge one
+vector<vector<int>> MakeIrregularCollections() {
+  vector<vector<int>> result{};
+  int next = 0;
+  for (int size : {5, 0, 100000, 1, 0, 0, 300, 7, 0}) {
+    result.emplace_back();
+    for (int i = 0; i < size; i++)
+      result.back().push_back(next++);
+  }
+  return result;
+}
+
+TEST(ParallelChainTest, SplitsNestedCollectionsByElement) {
+  ThreadPool pool{kThreads};
+  vector<vector<int>> collections = MakeIrregularCollections();
+  vector<int> expected(Chain(collections).begin(), Chain(collections).end());
+  auto add = [](long sum, long value) { return sum + value; };
+
+  EXPECT_EQ(expected, Chain(collections).parallel(pool).collect());
+  EXPECT_EQ(std::accumulate(expected.begin(), expected.end(), 0L), Chain(collections).parallel(pool).reduce(0L, add));
+}
+
+TEST(ParallelChainTest, SpreadsHugeNestedCollectionOverAllThreads) {
+  ThreadPool pool{kThreads};
+  vector<vector<int>> collections(3);
+  collections[1].resize(400);
+  std::mutex mutex;
+  std::set<std::thread::id> threads{};
+  Chain(collections).parallel(pool).for_each([&](int&) {
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+    std::lock_guard<std::mutex> lock(mutex);
+    threads.insert(std::this_thread::get_id());
+  });
+
+  EXPECT_EQ(kThreads, threads.size());
+}
+
+TEST(ParallelChainTest, CanModifyValues) {
+  ThreadPool pool{kThreads};
+  vector<vector<int>> collections = MakeIrregularCollections();
+  Chain(collections).parallel(pool).for_each([](int& value) { value = -value; });
+
+  EXPECT_EQ(-100004, collections[2].back());
+  EXPECT_EQ(-100005, collections[3][0]);
+}
+
+TEST(ParallelChainTest, SplitsByCollectionIfNestedCollectionsAreNotRandomAccess) {
+  ThreadPool pool{kThreads};
+  vector<std::list<int>> collections{};
+  for (const auto& collection : MakeIrregularCollections())
+    collections.emplace_back(collection.begin(), collection.end());
+  vector<int> expected(Chain(collections).begin(), Chain(collections).end());
+  auto add = [](long sum, long value) { return sum + value; };
+
+  EXPECT_EQ(expected, Chain(collections).parallel(pool).collect());
+  EXPECT_EQ(std::accumulate(expected.begin(), expected.end(), 0L), Chain(collections).parallel(pool).reduce(0L, add));
+}
+
+TEST(ParallelChainTest, SplitsIndexedChainByElement) {
+  ThreadPool pool{kThreads};
+  vector<vector<int>> collections = MakeIrregularCollections();
+  vector<int> expected(Chain(collections).begin(), Chain(collections).end());
+  auto add = [](long sum, long value) { return sum + value; };
+
+  EXPECT_EQ(expected, IndexedChain(collections).parallel(pool).collect());
+  EXPECT_EQ(std::accumulate(expected.begin(), expected.end(), 0L),
+            IndexedChain(collections).parallel(pool).reduce(0L, add));
+}
+
+TEST(ParallelChainTest, OverConstAndEmptyCollections) {
+  const vector<vector<int>> collections = MakeIrregularCollections();
+  const vector<vector<int>> empty{};
+  auto chained = Chain(collections);
+
+  EXPECT_EQ(vector<int>(chained.begin(), chained.end()), Parallel(chained).collect());
+  EXPECT_THAT(Chain(empty).parallel().collect(), ElementsAre());
+}
+
+template <typename T> vector<typename T::value_type> ToVector(const T& collection) {
+  return vector<typename T::value_type>(collection.begin(), collection.end());
+}
+
+// Counts the calls that run at the same time
+class InFlight {
+ public:
+  void Enter() {
+    const int current = ++current_;
+    int maximum = maximum_.load();
+    while (current > maximum && !maximum_.compare_exchange_weak(maximum, current)) {
+    }
+    ++calls_;
+  }
+  void Leave() { --current_; }
+
+  int Maximum() const { return maximum_; }
+  int Calls() const { return calls_; }
+
+ private:
+  std::atomic<int> current_{0};
+  std::atomic<int> maximum_{0};
+  std::atomic<int> calls_{0};
+};
+
+TEST(MapConcurrentTest, KeepsOrder) {
+  vector<int> values = MakeValues(200);
+  // Later elements finish first
+  auto slow_square = [](int value) {
+    std::this_thread::sleep_for(std::chrono::microseconds((200 - value) % 7 * 100));
+    return value * value;
+  };
+
+  vector<int> expected{};
+  for (int value : values)
+    expected.push_back(value * value);
+  auto squares = Iterate(values).map_concurrent(slow_square, 8);
+  EXPECT_EQ(expected, vector<int>(squares.begin(), squares.end()));
+}
+
+TEST(MapConcurrentTest, PostIncrementReturnsCurrentElement) {
+  vector<int> collection = MakeValues(10);
+  auto mapped = Iterate(collection).map_concurrent([](int value) { return value * 10; }, 1);
+  auto it = mapped.begin();
+
+  vector<int> values{};
+  while (it != mapped.end())
+    values.push_back(*it++);
+  EXPECT_THAT(values, ElementsAre(0, 10, 20, 30, 40, 50, 60, 70, 80, 90));
+}
+
+TEST(MapConcurrentTest, BoundsCallsInFlight) {
+  vector<int> values = MakeValues(40);
+  InFlight in_flight{};
+  auto slow_identity = [&in_flight](int value) {
+    in_flight.Enter();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    in_flight.Leave();
+    return value;
+  };
+
+  EXPECT_EQ(values, ToVector(MapConcurrent(values, slow_identity, 4)));
+  EXPECT_LE(in_flight.Maximum(), 4);
+  EXPECT_GE(in_flight.Maximum(), 2);
+}
+
+TEST(MapConcurrentTest, DoesNotRunAheadOfTheReader) {
+  vector<int> values = MakeValues(100);
+  InFlight in_flight{};
+  auto identity = [&in_flight](int value) {
+    in_flight.Enter();
+    in_flight.Leave();
+    return value;
+  };
+
+  auto mapped = Iterate(values).map_concurrent(identity, 4);
+  auto it = mapped.begin();
+  EXPECT_EQ(0, *it);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  // Only the buffer of 2 * 4 elements gets mapped while the first one is being read
+  EXPECT_EQ(8, in_flight.Calls());
+  ++it;
+  EXPECT_EQ(1, *it);
+}
+
+TEST(MapConcurrentTest, StopsWhenReaderStops) {
+  vector<int> values = MakeValues(1000);
+  std::atomic<int> calls{0};
+  auto count = [&calls](int value) {
+    ++calls;
+    return value;
+  };
+
+  for (int value : Iterate(values).map_concurrent(count, 4)) {
+    if (value == 10)
+      break;
+  }
+  EXPECT_LE(calls.load(), 11 + 8);
+}
+
+TEST(MapConcurrentTest, RethrowsExceptionOfElement) {
+  vector<int> values = MakeValues(10);
+  auto check = [](int value) {
+    if (value == 5)
+      throw std::invalid_argument("five");
+    return value;
+  };
+
+  vector<int> read{};
+  auto mapped = MapConcurrent(values, check, 3);
+  EXPECT_THROW(
+      {
+        for (int value : mapped)
+          read.push_back(value);
+      },
+      std::invalid_argument);
+  EXPECT_THAT(read, ElementsAre(0, 1, 2, 3, 4));
+}
+
+TEST(MapConcurrentTest, ChainsWithOtherOperators) {
+  std::list<string> words{"a", "bb", "", "ccc"};
+  auto length = [](const string& word) { return word.size(); };
+
+  auto lengths = Iterate(words).filter([](const string& word) { return !word.empty(); }).map_concurrent(length, 2);
+  EXPECT_THAT(ToVector(std::move(lengths).map([](std::size_t size) { return size * 10; })), ElementsAre(10, 20, 30));
+  EXPECT_THAT(ToVector(MapConcurrent(std::list<string>{}, length, 2)), ElementsAre());
+}
+
+TEST(AsyncBufferTest, PassesAllElementsInOrder) {
+  vector<int> values = MakeValues(100000);
+  auto is_odd = [](int value) { return value % 2 == 1; };
+  auto twice = [](int value) { return value * 2; };
+
+  vector<int> expected{};
+  for (int value : values) {
+    if (is_odd(value))
+      expected.push_back(value * 2 + 1);
+  }
+  auto buffered = Iterate(values).filter(is_odd).map(twice).async_buffer(1000).map([](int value) { return value + 1; });
+  EXPECT_EQ(expected, ToVector(buffered));
+}
+
+TEST(AsyncBufferTest, RunsUpstreamOnAnotherThread) {
+  std::list<int> values{1, 2, 3};
+  std::mutex mutex;
+  std::set<std::thread::id> threads{};
+  auto record_thread = [&](int value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    threads.insert(std::this_thread::get_id());
+    return value;
+  };
+
+  EXPECT_THAT(ToVector(AsyncBuffer(Iterate(values).map(record_thread), 2)), ElementsAre(1, 2, 3));
+  EXPECT_EQ(1, threads.size());
+  EXPECT_EQ(0, threads.count(std::this_thread::get_id()));
+}
+
+TEST(AsyncBufferTest, DoesNotRunAheadOfTheReader) {
+  vector<int> values = MakeValues(10000);
+  std::atomic<int> produced{0};
+  auto count = [&produced](int value) {
+    ++produced;
+    return value;
+  };
+
+  auto buffered = Iterate(values).map(count).async_buffer(64);
+  auto it = buffered.begin();
+  EXPECT_EQ(0, *it);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  // The ring of 64 elements, plus the batches held by the reader and by the thread
+  EXPECT_LE(produced.load(), 2 * 64);
+  EXPECT_GE(produced.load(), 64);
+  ++it;
+  EXPECT_EQ(1, *it);
+}
+
+TEST(AsyncBufferTest, StopsWhenReaderStops) {
+  vector<int> values = MakeValues(100000);
+  std::atomic<int> produced{0};
+  auto count = [&produced](int value) {
+    ++produced;
+    return value;
+  };
+
+  for (int value : Iterate(values).map(count).async_buffer(64)) {
+    if (value == 10)
+      break;
+  }
+  EXPECT_LT(produced.load(), 1000);
+}
+
+TEST(AsyncBufferTest, RethrowsUpstreamExceptionAfterPreviousElements) {
+  vector<int> values = MakeValues(1000);
+  auto check = [](int value) {
+    if (value == 500)
+      throw std::invalid_argument("500");
+    return value;
+  };
+
+  vector<int> read{};
+  auto buffered = Iterate(values).map(check).async_buffer(64);
+  EXPECT_THROW(
+      {
+        for (int value : buffered)
+          read.push_back(value);
+      },
+      std::invalid_argument);
+  EXPECT_EQ(MakeValues(500), read);
+}
+
+TEST(AsyncBufferTest, OverEmptyCollection) {
+  EXPECT_THAT(ToVector(AsyncBuffer(vector<int>{}, 16)), ElementsAre());
+  EXPECT_THAT(ToVector(Iterate(vector<int>{1}).async_buffer(0)), ElementsAre(1));
+}
+
+}  // namespace iterators